@@ -4,7 +4,10 @@ VBM* vbm = nullptr;
 
 void setup()
 {
-    vbm = new VBM();
+    // Static storage instead of the heap, constructed here and not as a global so the Arduino core
+    // (timers, millis) is initialized before the machine starts up
+    static VBM machine;
+    vbm = &machine;
 }
 
 void loop()
@@ -146,7 +146,7 @@ Button::Command Button::RegisteredButtonPress() noexcept
     if (!buttonCommandWasProcessed_)
     {
         buttonCommandWasProcessed_ = true;
-        LOG_BUTTON_SWITCH(String("Returning button state: ") + static_cast<int>(registeredButtonCommand_))
+        LOG_BUTTON_SWITCH("Returning button state: {}", static_cast<int>(registeredButtonCommand_))
         return registeredButtonCommand_;
     }
     else
@@ -157,7 +157,7 @@ void Button::Update() noexcept
 {
     const unsigned long currentTime = millis();
 
-    const int buttonIsPressed = !digitalRead(BUTTON_PIN_SWITCH);
+    const int buttonIsPressed = SwitchButtonPin::IsClosed();
 
     // Button pressed for the first time
     if (buttonIsPressed && buttonIsPressed != buttonWasPressed_)
@@ -178,7 +178,7 @@ void Button::Update() noexcept
         interruptButtonPressed_ = false;
         interruptButtonReleased_ = false;
 
-        LOG_BUTTON_SWITCH(String("Button press took ") + timeSinceBtnPress + " s");
+        LOG_BUTTON_SWITCH("Button press took {} s", timeSinceBtnPress)
 
         if (timeSinceBtnPress < BUTTON_PRESS_SHORT)
         {
@@ -1,6 +1,7 @@
 #ifndef __BUTTON_HPP
 #define __BUTTON_HPP
 
+#include "pins.hpp"
 #include "settings.hpp"
 
 // A software debounced button that registers click and long clicks.
@@ -21,7 +22,7 @@ public:
         : registeredButtonCommand_{Command::Nothing}, alreadyTriggered_{false}, timeButtonPressed_{0}, timeButtonReleased_{0}, buttonCommandWasProcessed_{true}, startupDelay_{1000}
 
     {
-        pinMode(BUTTON_PIN_SWITCH, INPUT_PULLUP);
+        SwitchButtonPin::Init();
         // attachInterrupt(digitalPinToInterrupt(BUTTON_PIN_SWITCH), Button::InterruptButton, CHANGE);
     }
 
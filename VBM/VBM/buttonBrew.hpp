@@ -1,6 +1,7 @@
 #ifndef __BUTTON_BREW_HPP
 #define __BUTTON_BREW_HPP
 
+#include "pins.hpp"
 #include "settings.hpp"
 
 // A software debounced button that registers click and long clicks.
@@ -9,13 +10,13 @@ class ButtonBrew final
 public:
     ButtonBrew()
     {
-        pinMode(BUTTON_PIN_BREW, INPUT_PULLUP);
+        BrewButtonPin::Init();
     }
 
     bool IsPressed() const noexcept
     {
-        const bool state = !digitalRead(BUTTON_PIN_BREW);
-        LOG_BUTTON_BREW(String("Brew button state: ") + state)
+        const bool state = BrewButtonPin::IsClosed();
+        LOG_BUTTON_BREW("Brew button state: {}", state)
         return state;
     }
 };
@@ -1,135 +1,339 @@
 #include "clock.hpp"
 
+#ifdef __AVR__
+#include <Wire.h>
+#endif
+
 // Time from 00:00 to 24:00 which is our max timer value in minutes for turn on and off
 static constexpr const auto MIDNIGHT = 24 * 60 - 1;
+static constexpr const unsigned long SECONDS_PER_DAY = 24UL * 60UL * 60UL;
+
+namespace
+{
+// Day of the week with sunday as 0, 1970-01-01 was a thursday
+inline uint8_t DayOfTheWeek(unsigned long int UnixTime) { return (UnixTime / SECONDS_PER_DAY + 4) % 7; }
+
+// Unix time the window of a timer starting on the given day turns off, the next day if it crosses midnight
+inline unsigned long int TurnOffTime(unsigned long int DayStart, const Clock::Timer& Timer)
+{
+    return DayStart + Timer.turnOffAt * 60UL + (Timer.turnOffAt <= Timer.turnOnAt ? SECONDS_PER_DAY : 0);
+}
+}  // namespace
 
 Clock::Clock(uint8_t NumberOfAvailableTimers)
-    : rtc_(new RTC_DS3231()),
-    turnOffAfterDuration_{0},
-      turnOnAt_{0},
-      turnOffAt_{0},
-      timerFiredOnceForTheDay_{0},
-      days_{0},
+    : rtc_(),
+      state_{State::Off},
       hasNewState_{false},
-      state_{State::Off}
+      rtcAvailable_{false},
+      timers_{},
+      numberOfTimers_{NumberOfAvailableTimers < NUMBER_OF_TIMERS ? NumberOfAvailableTimers : NUMBER_OF_TIMERS},
+      turnOffAfterDuration_{0},
+      heatUpTime_{0},
+      nextEventAt_{0},
+      nextEventState_{State::Off},
+      rtcUnixTime_{0},
+      rtcSyncedAt_{0},
+      nextCheckAt_{0}
 {
-    while (!Serial)
-        ;
-    while (!rtc_->begin())
+}
+
+bool Clock::Begin() noexcept
+{
+    if (Probe())
+        Reschedule();
+    else
     {
-        Serial.println("Couldn't find DS3231");
-        Serial.flush();
-        while (1)
-            delay(10);
+        LOG_CLOCK("DS3231 not found, running without timers")
+        ScheduleNextEvent(UnixTime());
     }
+    return rtcAvailable_;
 }
 
-Clock::~Clock() { delete rtc_; }
+bool Clock::Probe() noexcept
+{
+#if defined(WIRE_HAS_TIMEOUT)
+    // A loose cable can keep the bus busy forever, give up after the timeout and reset the bus
+    Wire.setWireTimeout(RTC_TIMEOUT, true);
+#endif
+    rtcAvailable_ = rtc_.begin();
+    return rtcAvailable_;
+}
 
 void Clock::Update() noexcept
 {
-    const auto oldState = state_;
-    const auto dateTime = rtc_->now();
-    const auto unixTime = dateTime.unixtime();
-
-    uint8_t weekday = 1 << dateTime.dayOfTheWeek();
-
-    //  LOG_CLOCK(String("Clock update: Current: ") + dateTime.hour() + ":" + dateTime.minute() + " timer1On: " +
-    //                GetHours(turnOnAt_) + ":" + GetMinutes(turnOnAt_) + " -- timer1Off: " + GetHours(turnOffAt_) + ":" + GetMinutes(turnOffAt_)
-    //                + " State:" + (int)state_ + " firedonceforday: " + timerFiredOnceForTheDay_ + " weekday:" + weekday)
+    // Nothing to do before the next transition or synchronization is due
+    if (static_cast<long>(millis() - nextCheckAt_) < 0)
+        return;
 
-    // Reset timer if day changes
-    if (timerFiredOnceForTheDay_ != 0 && timerFiredOnceForTheDay_ != weekday)
-        timerFiredOnceForTheDay_ = 0;
-
-    bool wouldTurnOff = false;
-    // If the machine should only turn on, turnOffAt_ is 0.
-    if (turnOffAt_ != 0 && (weekday & days_) && dateTime.hour() >= GetHours(turnOffAt_) &&
-        dateTime.minute() >= GetMinutes(turnOffAt_) && turnOffAt_ > turnOnAt_)
-        wouldTurnOff = true;
+    // The DS3231 came back, e.g. after a loose cable was fixed
+    if (!rtcAvailable_ && Probe())
+    {
+        LOG_CLOCK("DS3231 found, timers enabled")
+        Reschedule();
+        return;
+    }
 
-    // First the on stages, then the off stages to overwrite on stage.
-    // Assumption:
-    // One can only turn the machine off after it was turned on.
-    // It is not possible to turn a machine off and on later in the same day.
-    if (!timerFiredOnceForTheDay_ && state_ != State::On && turnOnAt_ != 0 && (weekday & days_) &&
-        dateTime.hour() >= GetHours(turnOnAt_) && dateTime.minute() >= GetMinutes(turnOnAt_))
+    Synchronize();
+    if (nextEventAt_ == 0 || rtcUnixTime_ < nextEventAt_)
     {
-        // Machine would not turn off and
-        // if the machine was manually turn off, it was before timer would turn it on, not after
-        if (!wouldTurnOff)
-        {
-            LOG_CLOCK(String("Turn on at: ") + dateTime.hour() + ":" + dateTime.minute() +
-                      " >= " + GetHours(turnOnAt_) + ":" + GetMinutes(turnOnAt_))
-            state_ = State::On;
-            hasNewState_ = true;
-            timerFiredOnceForTheDay_ = weekday;
-        }
+        ScheduleNextCheck();
+        return;
     }
 
-    if (turnOffAfterDuration_ != 0 && unixTime >= turnOffAfterDuration_)
+    if (turnOffAfterDuration_ != 0 && rtcUnixTime_ >= turnOffAfterDuration_)
     {
-        LOG_CLOCK(String("Turn off after duration: ") + turnOffAfterDuration_ + " >= " + unixTime)
+        LOG_CLOCK("Turn off after duration: {} >= {}", turnOffAfterDuration_, rtcUnixTime_)
         turnOffAfterDuration_ = 0;
-        state_ = State::Off;
-        hasNewState_ = true;
+        Switch(State::Off);
     }
-    if (wouldTurnOff && state_ != State::Off)
+    else if (nextEventState_ == State::On)
     {
-        // Check that off timer comes after the on timer, else ignore it
-        if (turnOffAt_ > turnOnAt_)
-        {
-            LOG_CLOCK(String("Turn off at: ") + dateTime.hour() + ":" + dateTime.minute() +
-                      " >= " + GetHours(turnOffAt_) + ":" + GetMinutes(turnOffAt_))
-            state_ = State::Off;
-            hasNewState_ = true;
-        }
-        else
-        {
-            LOG_CLOCK("Turn off time lies before turn on time and is therefore ignored")
-        }
+        LOG_CLOCK("Turn on at: {} <= {}", nextEventAt_, rtcUnixTime_)
+        Switch(State::On);
+    }
+    // One can only turn the machine off by timer after a timer turned it on
+    else if (state_ == State::On)
+    {
+        LOG_CLOCK("Turn off at: {} <= {}", nextEventAt_, rtcUnixTime_)
+        Switch(State::Off);
     }
+    ScheduleNextEvent(rtcUnixTime_);
+}
+
+void Clock::SetDays(const uint8_t Days, uint8_t Timer) noexcept
+{
+    if (Timer >= numberOfTimers_)
+        return;
+    LOG_CLOCK("Clock got new timer days: {} for timer {}", Days, Timer)
+    timers_[Timer].days = Days & 0x7F;
+    Reschedule();
 }
 
 void Clock::SetTurnOffIn(unsigned long int Duration) noexcept
 {
-    LOG_CLOCK(String("Clock got new off duration time: ") + Duration + " s")
-    turnOffAfterDuration_ = rtc_->now().unixtime() + Duration;
+    LOG_CLOCK("Clock got new off duration time: {} s", Duration)
+    Synchronize();
+    turnOffAfterDuration_ = rtcUnixTime_ + Duration;
+    ScheduleNextEvent(rtcUnixTime_);
 }
 
-void Clock::SetTurnOnAt(unsigned long int MinutesFromMidnight) noexcept
+void Clock::SetTurnOnAt(unsigned long int MinutesFromMidnight, uint8_t Timer) noexcept
 {
+    SetTurnOnAt(MinutesFromMidnight, Timer, false);
+}
+
+void Clock::SetReadyBy(unsigned long int MinutesFromMidnight, uint8_t Timer) noexcept
+{
+    SetTurnOnAt(MinutesFromMidnight, Timer, true);
+}
+
+void Clock::SetTurnOnAt(unsigned long int MinutesFromMidnight, uint8_t Timer, bool ReadyBy) noexcept
+{
+    if (Timer >= numberOfTimers_)
+        return;
     // truncate input to at least midnight
     if (MinutesFromMidnight > MIDNIGHT)
     {
         LOG_CLOCK("Invalid turn on input; truncate to midnight")
         MinutesFromMidnight = MinutesFromMidnight % MIDNIGHT;
     }
-    LOG_CLOCK(String("Clock got new turn on time: ") + MinutesFromMidnight)
-    turnOnAt_ = MinutesFromMidnight;
-    timerFiredOnceForTheDay_ = 0;
-    state_ = State::Off;
+    LOG_CLOCK("Clock got new turn on time: {} for timer {}, ready by: {}", MinutesFromMidnight, Timer, ReadyBy)
+    timers_[Timer].turnOnAt = MinutesFromMidnight;
+    timers_[Timer].readyBy = ReadyBy;
+    Reschedule();
 }
 
-void Clock::SetTurnOffAt(unsigned long int MinutesFromMidnight) noexcept
+void Clock::SetHeatUpTime(unsigned long int Seconds) noexcept
 {
+    // Windows start at most a day early, see ScheduleNextEvent
+    if (Seconds > SECONDS_PER_DAY / 2)
+        Seconds = SECONDS_PER_DAY / 2;
+    const unsigned long int change = Seconds > heatUpTime_ ? Seconds - heatUpTime_ : heatUpTime_ - Seconds;
+    if (change < CLOCK_HEAT_UP_RESOLUTION)
+        return;
+    heatUpTime_ = Seconds;
+
+    for (uint8_t i = 0; i < numberOfTimers_; ++i)
+    {
+        if (timers_[i].readyBy)
+        {
+            LOG_CLOCK("Heat-up time now {} s", heatUpTime_)
+            // May catch up on a window that now starts earlier
+            Reschedule();
+            return;
+        }
+    }
+}
+
+void Clock::SetTurnOffAt(unsigned long int MinutesFromMidnight, uint8_t Timer) noexcept
+{
+    if (Timer >= numberOfTimers_)
+        return;
     // truncate input to at least midnight
     if (MinutesFromMidnight > MIDNIGHT)
     {
         LOG_CLOCK("Invalid turn off input; truncate to midnight")
         MinutesFromMidnight = MinutesFromMidnight % MIDNIGHT;
     }
-    LOG_CLOCK(String("Clock got new turn off time: ") + MinutesFromMidnight)
-    turnOffAt_ = MinutesFromMidnight;
+    LOG_CLOCK("Clock got new turn off time: {} for timer {}", MinutesFromMidnight, Timer)
+    timers_[Timer].turnOffAt = MinutesFromMidnight;
+    Reschedule();
 }
 
 bool Clock::HasNewState() noexcept
 {
     if (hasNewState_)
     {
-        LOG_CLOCK(String("Clock has a new state: ") + static_cast<int>(state_))
+        LOG_CLOCK("Clock has a new state: {}", static_cast<int>(state_))
         hasNewState_ = false;
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+void Clock::SetTimeFromUnixTime(unsigned long int CurrentUnixTime)
+{
+    if (rtcAvailable_)
+        rtc_.adjust(DateTime(CurrentUnixTime));
+    else
+    {
+        rtcUnixTime_ = CurrentUnixTime;
+        rtcSyncedAt_ = millis();
+    }
+    Reschedule();
+}
+
+void Clock::Synchronize() noexcept
+{
+    if (rtcAvailable_)
+    {
+        rtcUnixTime_ = rtc_.now().unixtime();
+        rtcSyncedAt_ = millis();
+        return;
+    }
+    // Move the anchor by whole seconds only, so the time does not lose the fractions
+    const unsigned long int seconds = (millis() - rtcSyncedAt_) / 1000;
+    rtcUnixTime_ += seconds;
+    rtcSyncedAt_ += seconds * 1000;
+}
+
+void Clock::Switch(enum State NewState) noexcept
+{
+    state_ = NewState;
+    hasNewState_ = true;
+}
+
+void Clock::Reschedule() noexcept
+{
+    Synchronize();
+
+    // Catch up on a window that already started, e.g. after a reboot or when a timer was set for right now.
+    // A machine the timer already turned on is not switched again, so a manual turn off is kept.
+    const auto wasOn = state_ == State::On;
+    state_ = State::Off;
+    if (IsWithinOnWindow(rtcUnixTime_))
+    {
+        if (wasOn)
+            state_ = State::On;
+        else
+        {
+            LOG_CLOCK("Catch up on timer window at: {}", rtcUnixTime_)
+            Switch(State::On);
+        }
+    }
+    ScheduleNextEvent(rtcUnixTime_);
+}
+
+void Clock::ScheduleNextEvent(unsigned long int After) noexcept
+{
+    nextEventAt_ = 0;
+    nextEventState_ = State::Off;
+
+    // Earliest transition wins, an off transition at the same time as an on transition overrules it
+    const auto consider = [this, After](unsigned long int EventAt, enum State EventState) {
+        if (EventAt <= After)
+            return;
+        if (nextEventAt_ == 0 || EventAt < nextEventAt_ || (EventAt == nextEventAt_ && EventState == State::Off))
+        {
+            nextEventAt_ = EventAt;
+            nextEventState_ = EventState;
+        }
+    };
+
+    const unsigned long int today = After - After % SECONDS_PER_DAY;
+    const uint8_t weekday = DayOfTheWeek(After);
+    // Weekday timers need the time of the DS3231, the duration timer below does not
+    for (uint8_t i = 0; rtcAvailable_ && i < numberOfTimers_; ++i)
+    {
+        const auto& timer = timers_[i];
+        if (!timer.days)
+            continue;
+
+        // Start a day early for windows crossing midnight, a week ahead covers every weekday
+        for (int8_t offset = -1; offset <= 7; ++offset)
+        {
+            if (!(timer.days & (1 << ((weekday + 7 + offset) % 7))))
+                continue;
+            const unsigned long int dayStart = today + offset * static_cast<long>(SECONDS_PER_DAY);
+            if (timer.turnOnAt != 0)
+                consider(TurnOnTime(dayStart, timer), State::On);
+            // If the machine should only turn on, turnOffAt is 0.
+            if (timer.turnOffAt != 0)
+                consider(TurnOffTime(dayStart, timer), State::Off);
+        }
+    }
+
+    // The duration timer may already be due (duration of 0), it fires on the next update
+    if (turnOffAfterDuration_ != 0 && (nextEventAt_ == 0 || turnOffAfterDuration_ <= nextEventAt_))
+    {
+        nextEventAt_ = turnOffAfterDuration_;
+        nextEventState_ = State::Off;
+    }
+
+    LOG_CLOCK("Next timer event at: {} state: {}", nextEventAt_, static_cast<int>(nextEventState_))
+    ScheduleNextCheck();
+}
+
+void Clock::ScheduleNextCheck() noexcept
+{
+    // Check again when the transition is due or the clock needs to be synchronized, whatever comes first
+    nextCheckAt_ = rtcSyncedAt_ + CLOCK_SYNC_INTERVAL;
+    if (nextEventAt_ != 0)
+    {
+        const unsigned long int secondsToEvent = nextEventAt_ > rtcUnixTime_ ? nextEventAt_ - rtcUnixTime_ : 0;
+        if (secondsToEvent < CLOCK_SYNC_INTERVAL / 1000)
+            nextCheckAt_ = rtcSyncedAt_ + secondsToEvent * 1000;
+    }
+}
+
+bool Clock::IsWithinOnWindow(unsigned long int UnixTime) const noexcept
+{
+    const unsigned long int today = UnixTime - UnixTime % SECONDS_PER_DAY;
+    const uint8_t weekday = DayOfTheWeek(UnixTime);
+    for (uint8_t i = 0; rtcAvailable_ && i < numberOfTimers_; ++i)
+    {
+        const auto& timer = timers_[i];
+        if (!timer.days || timer.turnOnAt == 0)
+            continue;
+
+        // A window of yesterday may still be running past midnight, one of tomorrow may start early for ready-by
+        for (int8_t offset = -1; offset <= 1; ++offset)
+        {
+            if (!(timer.days & (1 << ((weekday + 7 + offset) % 7))))
+                continue;
+            const unsigned long int dayStart = today + offset * static_cast<long>(SECONDS_PER_DAY);
+            const unsigned long int onAt = TurnOnTime(dayStart, timer);
+            // Timers without off time keep the machine on for the rest of the day
+            const unsigned long int offAt =
+                timer.turnOffAt != 0 ? TurnOffTime(dayStart, timer) : dayStart + SECONDS_PER_DAY;
+            if (onAt <= UnixTime && UnixTime < offAt)
+                return true;
+        }
+    }
+    return false;
+}
+
+unsigned long int Clock::TurnOnTime(unsigned long int DayStart, const Timer& Timer) const noexcept
+{
+    return DayStart + Timer.turnOnAt * 60UL - (Timer.readyBy ? heatUpTime_ : 0);
+}
@@ -7,6 +7,8 @@
 
 #include "settings.hpp"
 
+// Weekday timers turning the machine on and off.
+// Days of a timer are a byte with sunday as lsb:
 // Sun = days & 0000_0001
 // Mon = days & 0000_0010
 // Tue = days & 0000_0100
@@ -14,6 +16,13 @@
 // Thu = days & 0001_0000
 // Fri = days & 0010_0000
 // Sat = days & 0100_0000
+//
+// The unix time of the next on/off transition is computed whenever a timer or the time changes. In between the
+// time is kept with millis() anchored to the DS3231, so Update is a single compare against a precomputed deadline.
+// A ready-by timer treats its on time as the time the machine should be ready by and turns it on earlier by the
+// heat-up time, which the machine keeps up to date with SetHeatUpTime as the boiler cools down.
+// Without a DS3231 the clock runs in degraded mode: the time is kept with millis() only, the weekday timers are off
+// and only the duration timer works. The DS3231 is probed again every CLOCK_SYNC_INTERVAL.
 class Clock final
 {
 public:
@@ -24,42 +33,64 @@ public:
         On   // Timer wants the machine to be on
     };
 
-    Clock(uint8_t NumberOfAvailableTimers = 1);
+    // One on/off window on selected weekdays. Times are minutes from midnight, 0 disables the transition.
+    // If the off time lies before the on time, the machine turns off on the next day (window crosses midnight).
+    struct Timer
+    {
+        uint8_t days;
+        uint16_t turnOnAt;
+        uint16_t turnOffAt;
+        bool readyBy;  // turnOnAt is the time to be ready by
+    };
+
+    // Available timers are limited to NUMBER_OF_TIMERS. Does not touch the DS3231, see Begin.
+    Clock(uint8_t NumberOfAvailableTimers = NUMBER_OF_TIMERS);
+
+    // Probes the DS3231 with a bus timeout of RTC_TIMEOUT and synchronizes to it.
+    // Returns false if it does not answer, the clock then runs without timers.
+    bool Begin() noexcept;
 
-    ~Clock();
+    // Whether the DS3231 answered, the weekday timers only run with it
+    bool IsAvailable() const noexcept { return rtcAvailable_; }
 
     void Update() noexcept;
 
+    // Number of timers that can be used
+    uint8_t NumberOfTimers() const noexcept { return numberOfTimers_; }
+
     // Get the weekdays the timer is active, represented as byte with sunday as lsb
-    uint8_t Days() const noexcept { return days_; }
+    uint8_t Days(uint8_t Timer = 0) const noexcept { return timers_[Timer].days; }
 
     // Sets the weekdays the timer is active, represented as byte with sunday as lsb
-    void SetDays(const uint8_t Days)
-    {
-        LOG_CLOCK(String("Clock got new timer days: ") + Days)
-        if (Days & (1 << rtc_->now().dayOfTheWeek()))
-        {
-            timerFiredOnceForTheDay_ = 0;
-            state_ = State::Off;
-        }
-        days_ = Days;
-    }
+    void SetDays(const uint8_t Days, uint8_t Timer = 0) noexcept;
 
     // Duration in seconds to turn the machine off.
     // Input changed to minutes in vbm.cpp; durationtimer:2 --> 2 * 60 --> Duration = 120 s)
     void SetTurnOffIn(unsigned long int Duration) noexcept;
 
     // Get the time to turn the machine on as minutes from midnight
-    unsigned long int TurnOnAt() const noexcept { return turnOnAt_; }
+    unsigned long int TurnOnAt(uint8_t Timer = 0) const noexcept { return timers_[Timer].turnOnAt; }
 
     // Set the time to turn the machine on as minutes from midnight
-    void SetTurnOnAt(unsigned long int MinutesFromMidnight) noexcept;
+    void SetTurnOnAt(unsigned long int MinutesFromMidnight, uint8_t Timer = 0) noexcept;
+
+    // Whether the on time of the timer is the time the machine should be ready by
+    bool IsReadyBy(uint8_t Timer = 0) const noexcept { return timers_[Timer].readyBy; }
+
+    // Set the time the machine should be ready by as minutes from midnight, replaces the on time.
+    // SetTurnOnAt turns the timer back into a plain one.
+    void SetReadyBy(unsigned long int MinutesFromMidnight, uint8_t Timer = 0) noexcept;
+
+    // Seconds a ready-by timer turns the machine on before its time. Smaller changes than CLOCK_HEAT_UP_RESOLUTION
+    // are ignored so the timers are not planned anew on every loop.
+    void SetHeatUpTime(unsigned long int Seconds) noexcept;
+    unsigned long int HeatUpTime() const noexcept { return heatUpTime_; }
 
     // Get the time to turn the machine on as minutes from midnight
-    unsigned long int TurnOffAt() const noexcept { return turnOffAt_; }
+    unsigned long int TurnOffAt(uint8_t Timer = 0) const noexcept { return timers_[Timer].turnOffAt; }
 
     // Time to turn the machine off as minutes from midnight
-    void SetTurnOffAt(unsigned long int MinutesFromMidnight) noexcept;
+    void SetTurnOffAt(unsigned long int MinutesFromMidnight, uint8_t Timer = 0) noexcept;
 
     // Get the current timer state
     State State() const noexcept { return state_; }
@@ -67,35 +98,67 @@ public:
     // Gets whether the clock timer state has changed
     bool HasNewState() noexcept;
 
-    // Get the current unix time
-    unsigned long int UnixTime() noexcept
+    // Get the current unix time, kept with millis() between synchronizations with the DS3231
+    unsigned long int UnixTime() const noexcept
     {
-        return rtc_->now().unixtime();
+        return rtcUnixTime_ + (millis() - rtcSyncedAt_) / 1000;
     }
 
-    void SetTimeFromUnixTime(unsigned long int CurrentUnixTime)
-    {
-        rtc_->adjust(DateTime(CurrentUnixTime));
-    }
+    // Unix time of the next timer transition, 0 if there is none
+    unsigned long int NextEventAt() const noexcept { return nextEventAt_; }
+
+    void SetTimeFromUnixTime(unsigned long int CurrentUnixTime);
 
-    RTC_DS3231 *rtc_;
+    // Reading the DS3231 does not change the clock, so it can be read from const methods
+    mutable RTC_DS3231 rtc_;
 private:
-    inline unsigned long int GetHours(unsigned long int MinutesFromMidnight)
-    {
-        return (MinutesFromMidnight - GetMinutes(MinutesFromMidnight)) / 60;
-    }
+    // Sets the on time of a timer, ReadyBy: the machine should be ready at it
+    void SetTurnOnAt(unsigned long int MinutesFromMidnight, uint8_t Timer, bool ReadyBy) noexcept;
+
+    // Checks whether the DS3231 answers, never blocks longer than the bus timeout
+    bool Probe() noexcept;
+
+    // Read the DS3231 and anchor millis() to it, without the DS3231 just move the anchor
+    void Synchronize() noexcept;
+
+    // Set the state and notify the machine
+    void Switch(enum State NewState) noexcept;
+
+    // Timers changed: forget the state the timers had set, catch up on a window we are currently in and plan anew
+    void Reschedule() noexcept;
 
-    inline unsigned long int GetMinutes(unsigned long int MinutesFromMidnight) { return MinutesFromMidnight % 60; }
+    // Find the first transition of all timers after the given unix time and set the next deadline for Update
+    void ScheduleNextEvent(unsigned long int After) noexcept;
+
+    // Set the millis() deadline for Update from the next transition and the synchronization interval
+    void ScheduleNextCheck() noexcept;
+
+    // Whether the given unix time lies within an on window of any timer
+    bool IsWithinOnWindow(unsigned long int UnixTime) const noexcept;
+
+    // Unix time the window of a timer starting on the given day turns on
+    unsigned long int TurnOnTime(unsigned long int DayStart, const Timer& Timer) const noexcept;
 
     enum State state_;
 
     bool hasNewState_;
+    bool rtcAvailable_;
 
+    Timer timers_[NUMBER_OF_TIMERS];
+    uint8_t numberOfTimers_;
     unsigned long int turnOffAfterDuration_;
-    uint8_t days_;
-    unsigned long int turnOnAt_;
-    unsigned long int turnOffAt_;
-    uint8_t timerFiredOnceForTheDay_;
+    unsigned long int heatUpTime_;
+
+    // Next transition as unix time and the state it switches to
+    unsigned long int nextEventAt_;
+    enum State nextEventState_;
+
+    // DS3231 time at the last synchronization and the millis() it was read at
+    unsigned long int rtcUnixTime_;
+    unsigned long rtcSyncedAt_;
+
+    // millis() when Update has something to do: the next transition or the next synchronization
+    unsigned long nextCheckAt_;
 };
 
 #endif
@@ -1,10 +1,26 @@
 #include "communicator.hpp"
 
-Communicator::Communicator() : receivedMessage_(""), receivedCommand_{Command::None}
+namespace
 {
+// Reads the 1 based timer or profile number starting at Start (timer2on --> 2) and returns it 0 based, or
+// Communicator::NO_INDEX for a missing, 0 or too large number. End is set behind the last digit.
+uint8_t ParseTimer(const String& Message, unsigned int Start, unsigned int& End)
+{
+    unsigned int number = 0;
+    for (End = Start; End < Message.length() && Message[End] >= '0' && Message[End] <= '9'; ++End)
+        if (number <= Communicator::NO_INDEX)
+            number = number * 10 + (Message[End] - '0');
+    return number && number <= Communicator::NO_INDEX ? number - 1 : Communicator::NO_INDEX;
+}
+}  // namespace
+
+constexpr const uint8_t Communicator::NO_INDEX;
+
+Communicator::Communicator()
+    : receivedMessage_(""), receivedCommand_{Command::None}, receivedTimer_{0}, receivedSegment_{0}
+{
+    // Serial on the ATmega328P is always ready, waiting for it would only block boards with native USB
     Serial.begin(57600);
-    while (!Serial)
-        ;
 
     // This helps to see if the device crashes or resets at some point.
     Serial.println("Communicator initialized!");
@@ -19,6 +35,9 @@ enum Communicator::Command Communicator::Command() noexcept
 
 void Communicator::Update() noexcept
 {
+    // Hand queued messages to the UART as far as there is room, never wait for it
+    TxQueue::Flush();
+
     // Reset the received message which is only valid for one update cycle and contains the value as well
     receivedMessage_ = "";
 
@@ -30,7 +49,7 @@ void Communicator::Update() noexcept
 
     if (receivedMessage_.length())
     {  // if string is not empty do the following
-        LOG_COMM(String("Received Message: ") + receivedMessage_)
+        LOG_COMM("Received Message: {}", receivedMessage_.c_str())
 
         auto receivedMessageLower(receivedMessage_);
         receivedMessageLower.toLowerCase();
@@ -40,6 +59,36 @@ void Communicator::Update() noexcept
             receivedCommand_ = Command::TurnOn;
         else if (receivedMessageLower == "turnoff")
             receivedCommand_ = Command::TurnOff;
+        else if (receivedMessageLower == "mem")
+            receivedCommand_ = Command::Memory;
+        else if (receivedMessageLower == "statelog")
+            receivedCommand_ = Command::StateLog;
+        else if (receivedMessageLower == "blackbox")
+            receivedCommand_ = Command::BlackBox;
+        else if (receivedMessageLower == "supervisor")
+            receivedCommand_ = Command::Supervisor;
+        else if (receivedMessageLower == "stats")
+            receivedCommand_ = Command::Stats;
+        else if (receivedMessageLower == "pumpprofiles")
+            receivedCommand_ = Command::PumpProfiles;
+        else if (receivedMessageLower.startsWith(String("pumpprofile")))
+        {
+            receivedCommand_ = Command::PumpProfile;
+        }
+        else if (receivedMessageLower.startsWith(String("profile")))
+        {
+            unsigned int end = 0;
+            receivedTimer_ = ParseTimer(receivedMessageLower, 7, end);
+            if (receivedMessageLower.substring(end).startsWith(String("segment")))
+            {
+                receivedSegment_ = ParseTimer(receivedMessageLower, end + 7, end);
+                const auto action = receivedMessageLower.substring(end);
+                if (action.startsWith(String("duty")))
+                    receivedCommand_ = Command::SegmentDuty;
+                else if (action.startsWith(String("time")))
+                    receivedCommand_ = Command::SegmentTime;
+            }
+        }
         else if (receivedMessageLower.startsWith(String("setpointbrew")))
         {
             receivedCommand_ = Command::UpdateSetpointBrew;
@@ -48,26 +97,60 @@ void Communicator::Update() noexcept
         {
             receivedCommand_ = Command::UpdateSetpointSteam;
         }
-        else if (receivedMessageLower.startsWith(String("durationtimer")))
+        else if (receivedMessageLower.startsWith(String("setpointeco")))
         {
-            receivedCommand_ = Command::DurationTimer;
+            receivedCommand_ = Command::UpdateSetpointEco;
+        }
+        else if (receivedMessageLower.startsWith(String("setpointgroup")))
+        {
+            receivedCommand_ = Command::UpdateSetpointGroup;
+        }
+        else if (receivedMessageLower.startsWith(String("sleeptimeout")))
+        {
+            receivedCommand_ = Command::SleepTimeout;
+        }
+        else if (receivedMessageLower.startsWith(String("heaterwattage")))
+        {
+            receivedCommand_ = Command::HeaterWattage;
+        }
+        else if (receivedMessageLower.startsWith(String("targetvolume")))
+        {
+            receivedCommand_ = Command::TargetVolume;
         }
-        else if (receivedMessageLower.startsWith(String("daystimer1")))
+        else if (receivedMessageLower.startsWith(String("pressurelimit")))
         {
-            receivedCommand_ = Command::DaysTimer1;
+            receivedCommand_ = Command::PumpPressureLimit;
+        }
+        else if (receivedMessageLower.startsWith(String("durationtimer")))
+        {
+            receivedCommand_ = Command::DurationTimer;
         }
-        else if (receivedMessageLower.startsWith(String("timer1on")))
+        else if (receivedMessageLower.startsWith(String("daystimer")))
         {
-            receivedCommand_ = Command::Timer1On;
+            unsigned int end = 0;
+            receivedTimer_ = ParseTimer(receivedMessageLower, 9, end);
+            receivedCommand_ = Command::DaysTimer;
         }
-        else if (receivedMessageLower.startsWith(String("timer1off")))
+        else if (receivedMessageLower.startsWith(String("timer")))
         {
-            receivedCommand_ = Command::Timer1Off;
+            unsigned int end = 0;
+            receivedTimer_ = ParseTimer(receivedMessageLower, 5, end);
+            const auto action = receivedMessageLower.substring(end);
+            if (action.startsWith(String("on")))
+                receivedCommand_ = Command::TimerOn;
+            else if (action.startsWith(String("off")))
+                receivedCommand_ = Command::TimerOff;
+            else if (action.startsWith(String("readyby")))
+                receivedCommand_ = Command::TimerReadyBy;
         }
         else if (receivedMessageLower.startsWith(String("setunixtime")))
         {
             receivedCommand_ = Command::SetUnixTime;
         }
+        else if (receivedMessageLower.startsWith(String("updateapp:since")))
+        {
+            receivedCommand_ = Command::UpdateAppSince;
+        }
         else if (receivedMessageLower.startsWith(String("updateapp")))
         {
             receivedCommand_ = Command::UpdateApp;
@@ -75,13 +158,37 @@ void Communicator::Update() noexcept
     }
 }
 
-void Communicator::SendMessageOnce(String Message) const noexcept
+void Communicator::Value(float& Value) const noexcept
+{
+    double value = 0;
+    this->Value(value);
+    Value = static_cast<float>(value);
+}
+
+void Communicator::Value(double& Value) const noexcept
+{
+    const auto numberStartsAfter = receivedMessage_.lastIndexOf(':');
+    Value = strtod(receivedMessage_.substring(numberStartsAfter + 1).c_str(), nullptr);
+    LOG_COMM("returning value from message: {}; extracted value: {}", receivedMessage_.c_str(), Value)
+}
+
+void Communicator::SendMessageOnce(const char* Message) const noexcept
+{
+    LOG_COMM("Sending message: {}", Message)
+    TxQueue::Push(Message);
+}
+
+void Communicator::SendMessageOnce(const char* Message, double Value) const noexcept
+{
+    TxLine().Append(">").Append(Message).Append(":").Append(Value, 2).Send();
+}
+
+void Communicator::Send(PGM_P Key, long Value) const noexcept
 {
-    LOG_COMM(String("Sending message: ") + Message)
-    Serial.println(Message);
+    TxLine().Append(">").AppendP(Key).Append(":").Append(Value).Send();
 }
 
-void Communicator::SendMessageOnce(String Message, double Value) const noexcept
+void Communicator::Send(PGM_P Key, double Value, uint8_t Decimals) const noexcept
 {
-    SendMessageOnce(String(">") + Message + ":" + Value);
+    TxLine().Append(">").AppendP(Key).Append(":").Append(Value, Decimals).Send();
 }
@@ -3,8 +3,10 @@
 
 #include "eepromMemory.hpp"
 #include "settings.hpp"
+#include "txQueue.hpp"
 
-// Opens a serial connection and sends/retrieves data
+// Opens a serial connection and sends/retrieves data. Outgoing messages are queued on the TxQueue and handed to
+// the UART a few bytes per Update, so sending never blocks the machine.
 class Communicator
 {
   public:
@@ -16,31 +18,65 @@ class Communicator
         TurnOn,
         UpdateSetpointBrew,
         UpdateSetpointSteam,
+        UpdateSetpointEco,  // setpoint while asleep
+        UpdateSetpointGroup, // group temperature the brew setpoint is trimmed for, 0 none
+        SleepTimeout,       // minutes without input until the machine sleeps, 0 never
+        HeaterWattage,      // rated heater power in W for the energy meter
+        TargetVolume,       // ml after which the pump stops, 0 never
+        PumpPressureLimit,  // bar the pump holds the pressure below, 0 none
         DurationTimer,  // duration in seconds when to turn the machine off starting now
-        DaysTimer1,     // weekdays timer 1 should be active
-        Timer1On,       // time when to turn the machine on in minutes from midnight
-        Timer1Off,      // time when to turn the machine off in minutes from midnight
+        DaysTimer,      // weekdays a timer should be active, daystimer<N>, see Timer()
+        TimerOn,        // time when to turn the machine on in minutes from midnight, timer<N>on
+        TimerOff,       // time when to turn the machine off in minutes from midnight, timer<N>off
+        TimerReadyBy,   // time the machine should be ready by in minutes from midnight, timer<N>readyby
+        PumpProfile,    // pump profile to brew with, 0 for none
+        SegmentDuty,    // pump duty of a profile segment in percent, profile<N>segment<M>duty, see Segment()
+        SegmentTime,    // duration of a profile segment in 1/10 s, profile<N>segment<M>time, see Segment()
+        PumpProfiles,   // send all pump profiles
         SetUnixTime,    // current time from App as unix time stamp
-        UpdateApp       // send all interesting parameters to the connected application
+        UpdateApp,      // send all interesting parameters to the connected application
+        UpdateAppSince, // send only the parameters changed after a version, updateapp:since:<version>
+        Memory,         // send heap and stack usage
+        StateLog,       // send the last state transitions
+        BlackBox,       // send the flight recorder saved on the last error or watchdog/brown-out reset
+        Supervisor,     // send the supervisor fault and its worst case reaction latency
+        Stats           // send the energy and usage counters
     };
 
+    // Timer, profile or segment of a command without a valid number
+    static constexpr const uint8_t NO_INDEX = 0xFF;
+
     Communicator();
 
     // Gets the last received command
     Command Command() noexcept;
 
-    // Gets the last received value
+    // Gets the last received value, the number after the last ':'. Whole numbers for integer types, decimals only
+    // for float and double.
     template <class T>
     void Value(T& Value) const noexcept;
+    void Value(float& Value) const noexcept;
+    void Value(double& Value) const noexcept;
+
+    // Gets the timer the last received timer command is meant for, 0 based (timer1on --> 0), or NO_INDEX
+    uint8_t Timer() const noexcept { return receivedTimer_; }
 
-    // Update loop checks for a new message and retrieves it completely in one go.
+    // Gets the profile and the segment the last received segment command is meant for, 0 based, or NO_INDEX
+    uint8_t Profile() const noexcept { return receivedTimer_; }
+    uint8_t Segment() const noexcept { return receivedSegment_; }
+
+    // Update loop checks for a new message and retrieves it completely in one go and sends queued messages.
     void Update() noexcept;
 
     // Send a message once, not in a loop
-    void SendMessageOnce(String Message) const noexcept;
+    void SendMessageOnce(const char* Message) const noexcept;
 
     // Sends a message once, formatted as command
-    void SendMessageOnce(String Message, double Value) const noexcept;
+    void SendMessageOnce(const char* Message, double Value) const noexcept;
+
+    // Sends a value formatted as command (>Key:Value), Key is a string in flash, e.g. Send(PSTR("unixtime"), now)
+    void Send(PGM_P Key, long Value) const noexcept;
+    void Send(PGM_P Key, double Value, uint8_t Decimals) const noexcept;
 
     // TODO: Send message for use in loop, set how often this should update. Like update the temp for display
     // in the app, but update it once a second or mabye twice should be enough.
@@ -48,14 +84,16 @@ class Communicator
   private:
     String receivedMessage_;
     enum Command receivedCommand_;
+    uint8_t receivedTimer_;  // or profile
+    uint8_t receivedSegment_;
 };
 
 template <class T>
 void Communicator::Value(T& Value) const noexcept
 {
-    const auto numberStartsAfter = receivedMessage_.indexOf(String(":"));
+    const auto numberStartsAfter = receivedMessage_.lastIndexOf(':');
     Value = static_cast<T>(strtoul(receivedMessage_.substring(numberStartsAfter + 1).c_str(), nullptr, 10));
-    LOG_COMM(String("returning value from message: ") + receivedMessage_ + "; extracted value: " + Value)
+    LOG_COMM("returning value from message: {}; extracted value: {}", receivedMessage_.c_str(), Value)
 }
 
 #endif
@@ -0,0 +1,24 @@
+#include "eepromMemory.hpp"
+
+// Increment the index by the sum of the previous sizes times their count, set the size to the desired one for the new
+// parameter. Everything from STATS_EEPROM on belongs to the energy meter and the flight recorder.
+const uint8_t Eeprom::eepromIdx_[18][3] PROGMEM = {
+    {0, 4, 1},                                         // {{SetpointBrew, double, 1},
+    {4, 4, 1},                                         //  {SetpointSteam, double, 1},
+    {8, 1, 1},                                         //  {Timer1Days, byte, 1}
+    {9, 4, 1},                                         //  {Timer1TurnOn, unsigned long int, 1}
+    {13, 4, 1},                                        //  {Timer1TurnOff, unsigned long int, 1}
+    {17, 1, NUMBER_OF_TIMERS},                         //  {TimerDays, byte, NUMBER_OF_TIMERS}
+    {17 + NUMBER_OF_TIMERS, 2, NUMBER_OF_TIMERS},      //  {TimerTurnOn, unsigned int, NUMBER_OF_TIMERS}
+    {17 + 3 * NUMBER_OF_TIMERS, 2, NUMBER_OF_TIMERS},  //  {TimerTurnOff, unsigned int, NUMBER_OF_TIMERS}
+    {17 + 5 * NUMBER_OF_TIMERS, 4, 1},                 //  {SetpointEco, double, 1}
+    {21 + 5 * NUMBER_OF_TIMERS, 2, 1},                 //  {SleepTimeout, unsigned int, 1}
+    {23 + 5 * NUMBER_OF_TIMERS, 2, 1},                 //  {HeaterWattage, unsigned int, 1}
+    {25 + 5 * NUMBER_OF_TIMERS, 1, NUMBER_OF_TIMERS},  //  {TimerReadyBy, byte, NUMBER_OF_TIMERS}
+    {25 + 6 * NUMBER_OF_TIMERS, 4, 1},                 //  {HeatingRate, double, 1}
+    {29 + 6 * NUMBER_OF_TIMERS, 1, 1},                 //  {PumpProfile, byte, 1}
+    {30 + 6 * NUMBER_OF_TIMERS, 2, PUMP_PROFILES * PUMP_PROFILE_SEGMENTS},  //  {PumpSegment, 2 bytes, all}
+    {30 + 6 * NUMBER_OF_TIMERS + 2 * PUMP_PROFILES * PUMP_PROFILE_SEGMENTS, 2, 1},   //  {TargetVolume, uint, 1}
+    {32 + 6 * NUMBER_OF_TIMERS + 2 * PUMP_PROFILES * PUMP_PROFILE_SEGMENTS, 4, 1},   //  {PressureLimit, double, 1}
+    {36 + 6 * NUMBER_OF_TIMERS + 2 * PUMP_PROFILES * PUMP_PROFILE_SEGMENTS, 4, 1}};  //  {SetpointGroup, double, 1}}
+
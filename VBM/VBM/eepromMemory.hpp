@@ -11,7 +11,7 @@ class Eeprom
     // Add all available load/save types
     // Note: on AVR devices, double and float have the same precision (4 byte), same as unsigned long.
     // ATTENTION:
-    // 1. Make sure to update the eepromIdx_ below accordingly!
+    // 1. Make sure to update the eepromIdx_ in eepromMemory.cpp accordingly!
     // 2. Make sure to update global variables in settings.hpp and settings.cpp
     // 3. Make sure to update VBM constructor with the initialization and the initial getter
     // 4. Probably want to set on communication the eeprom:
@@ -21,72 +21,101 @@ class Eeprom
     {
         SetpointBrew = 0,  // double
         SetpointSteam,     // double
-        Timer1Days,        // byte
-        Timer1TurnOn,      // unsigned long int
-        Timer1TurnOff,     // unsigned long int
+        Timer1Days,        // byte, legacy single timer, only read to migrate to TimerDays
+        Timer1TurnOn,      // unsigned long int, legacy single timer, only read to migrate to TimerTurnOn
+        Timer1TurnOff,     // unsigned long int, legacy single timer, only read to migrate to TimerTurnOff
+        TimerDays,         // byte for each of the NUMBER_OF_TIMERS timers
+        TimerTurnOn,       // unsigned int for each of the NUMBER_OF_TIMERS timers
+        TimerTurnOff,      // unsigned int for each of the NUMBER_OF_TIMERS timers
+        SetpointEco,       // double
+        SleepTimeout,      // unsigned int
+        HeaterWattage,     // unsigned int
+        TimerReadyBy,      // byte for each of the NUMBER_OF_TIMERS timers, 1 if the on time is the ready-by time
+        HeatingRate,       // double, learned heating rate in degrees/s
+        PumpProfile,       // byte, selected pump profile, 0 for none
+        PumpSegment,       // uint16_t, time << 8 | duty, for each segment of each of the PUMP_PROFILES profiles
+        TargetVolume,      // unsigned int
+        PumpPressureLimit, // double
+        SetpointGroup,     // double
     };
 
     // Saves a value from a known Parameter and manages sorting of size and position in EEPROM.
     // Returns true if all goes well, false otherwise.
     template <class T>
-    bool Save(Parameter Parameter, T Value) noexcept;
+    bool Save(Parameter Parameter, T Value) noexcept
+    {
+        return Save(Parameter, 0, Value);
+    }
+
+    // Saves the value at Index of a parameter stored for several instances, like one per timer.
+    template <class T>
+    bool Save(Parameter Parameter, uint8_t Index, T Value) noexcept;
 
     // Loads a value for an known parameter and manages sorting of size and position in EEPROM.
     // Returns true if all goes well, false otherwise. Value only changed on success.
     template <class T>
-    bool Load(Parameter Parameter, T& Value) const noexcept;
+    bool Load(Parameter Parameter, T& Value) const noexcept
+    {
+        return Load(Parameter, 0, Value);
+    }
+
+    // Loads the value at Index of a parameter stored for several instances, like one per timer.
+    template <class T>
+    bool Load(Parameter Parameter, uint8_t Index, T& Value) const noexcept;
 
   private:
-    // Array to save the eeprom index and expected size of each savable/loadable value.
-    // Increment the index by the sum of the previous sizes, set the size to the desired one for the new parameter.
-    const uint8_t eepromIdx_[5][2] = {{0, 4},    // {{SetpointBrew, double},
-                                      {4, 4},    //  {SetpointSteam, double},
-                                      {8, 1},    //  {Timer1Days, byte}
-                                      {9, 4},    //  {Timer1TurnOn, unsigned long int}
-                                      {13, 4}};  //  {Timer1TurnOff, unsigned long int}}
+    // Array to save the eeprom index, expected size and number of instances of each savable/loadable value.
+    // Kept in flash, see eepromMemory.cpp.
+    static const uint8_t eepromIdx_[18][3];
+
+    // Column 0: index, 1: size, 2: number of instances of a parameter
+    static uint8_t Layout(Parameter Parameter, uint8_t Column) noexcept
+    {
+        return pgm_read_byte(&eepromIdx_[static_cast<uint8_t>(Parameter)][Column]);
+    }
 };
 
 template <class T>
-bool Eeprom::Save(Parameter Parameter, T Value) noexcept
+bool Eeprom::Save(Parameter Parameter, uint8_t Index, T Value) noexcept
 {
     const auto size = sizeof(T);
-    LOG_EEPROM_MEMORY(String("Checking Save to eeprom; Idx: ") + eepromIdx_[static_cast<uint8_t>(Parameter)][0] +
-                      ", expected size: " + eepromIdx_[static_cast<uint8_t>(Parameter)][1] + ", actual size: " + size)
-    if (eepromIdx_[static_cast<uint8_t>(Parameter)][1] != size)
+    LOG_EEPROM_MEMORY("Checking Save to eeprom; Idx: {}, expected size: {}, actual size: {}",
+                      Layout(Parameter, 0), Layout(Parameter, 1), static_cast<uint8_t>(size))
+    if (Layout(Parameter, 1) != size || Index >= Layout(Parameter, 2))
         return false;
     LOG_EEPROM_MEMORY("OK")
 
     byte* byteArray = reinterpret_cast<byte*>(&Value);
-    const auto location = eepromIdx_[static_cast<uint8_t>(Parameter)][0];
+    const auto location = Layout(Parameter, 0) + Index * size;
     for (auto i = 0; i < size; i++)
     {
         EEPROM.write(location + i, byteArray[i]);
-        LOG_EEPROM_MEMORY(String("Saving ") + byteArray[i] + " to eeprom location " + (location + i))
+        LOG_EEPROM_MEMORY("Saving {} to eeprom location {}", byteArray[i], location + i)
     }
     return true;
 }
 
 template <class T>
-bool Eeprom::Load(Parameter Parameter, T& Value) const noexcept
+bool Eeprom::Load(Parameter Parameter, uint8_t Index, T& Value) const noexcept
 {
     const auto size = sizeof(T);
 
-    LOG_EEPROM_MEMORY(String("Checking Load from eeprom; Idx: ") + eepromIdx_[static_cast<uint8_t>(Parameter)][0] +
-                      ", expected size: " + eepromIdx_[static_cast<uint8_t>(Parameter)][1] + ", actual size: " + size)
-    if (eepromIdx_[static_cast<uint8_t>(Parameter)][1] != size)
+    LOG_EEPROM_MEMORY("Checking Load from eeprom; Idx: {}, expected size: {}, actual size: {}",
+                      Layout(Parameter, 0), Layout(Parameter, 1), static_cast<uint8_t>(size))
+    if (Layout(Parameter, 1) != size || Index >= Layout(Parameter, 2))
         return false;
     LOG_EEPROM_MEMORY("OK; loaded")
 
     byte byteArray[size];
-    const auto location = eepromIdx_[static_cast<uint8_t>(Parameter)][0];
+    const auto location = Layout(Parameter, 0) + Index * size;
     for (auto i = 0; i < size; i++)
     {
         byteArray[i] = EEPROM.read(location + i);
-        LOG_EEPROM_MEMORY(String("Loading ") + byteArray[i] + " from eeprom location" + (location + i))
+        LOG_EEPROM_MEMORY("Loading {} from eeprom location {}", byteArray[i], location + i)
     }
 
-    LOG_EEPROM_MEMORY_PRECISION(Value)
     Value = *reinterpret_cast<T*>(byteArray);
+    LOG_EEPROM_MEMORY_PRECISION("Loaded value: {}", Value)
     return true;
 }
 
@@ -0,0 +1,136 @@
+#include "energyMeter.hpp"
+
+EnergyMeter::EnergyMeter() noexcept
+    : counters_{},
+      energy_{},
+      heaterOn_{0},
+      pumpOn_{0},
+      powered_{0},
+      lastUpdateAt_{0},
+      brewingSince_{0},
+      savedAt_{0},
+      saving_{},
+      saveSlot_{0},
+      savePosition_{sizeof(Counters)}
+{
+}
+
+void EnergyMeter::Begin() noexcept
+{
+    Counters slots[2];
+    bool valid[2];
+    for (uint8_t slot = 0; slot < 2; ++slot)
+    {
+        EEPROM.get(SlotAddress(slot), slots[slot]);
+        valid[slot] = slots[slot].checksum == Checksum(slots[slot]);
+    }
+    // The sequence wraps around, the newer slot is the one just ahead
+    const bool secondIsNewer = static_cast<int16_t>(slots[1].sequence - slots[0].sequence) > 0;
+    const uint8_t newest = valid[1] && (!valid[0] || secondIsNewer) ? 1 : 0;
+    if (valid[newest])
+    {
+        counters_ = slots[newest];
+        saveSlot_ = !newest;
+    }
+    else
+    {
+        counters_ = Counters{};
+        saveSlot_ = 0;
+    }
+    LOG_VBM("Energy meter loaded slot {} valid {}, {} Wh", newest, valid[newest], Energy())
+}
+
+void EnergyMeter::Update(double Power, bool PumpOn, Usage Usage, uint16_t Day, unsigned long Now) noexcept
+{
+    const unsigned long dt = Now - lastUpdateAt_;
+    lastUpdateAt_ = Now;
+
+    if (Day != counters_.day)
+        StartDay(Day);
+
+    // Whole units go to the counters, the rest stays for the next call
+    double& energy = energy_[static_cast<uint8_t>(Usage)];
+    energy += Power * HEATER_WATTAGE * dt / 1000.0;
+    if (energy >= 3600)
+    {
+        const uint16_t wh = energy / 3600;
+        energy -= wh * 3600.0;
+        counters_.energy[static_cast<uint8_t>(Usage)] += wh;
+        counters_.days[0] += wh;
+    }
+    heaterOn_ += Power * dt / 1000.0;
+    if (heaterOn_ >= 1)
+    {
+        const uint16_t seconds = heaterOn_;
+        heaterOn_ -= seconds;
+        counters_.heaterOn += seconds;
+    }
+    if (PumpOn)
+        pumpOn_ += dt;
+    counters_.pumpOn += pumpOn_ / 1000;
+    pumpOn_ %= 1000;
+    powered_ += dt;
+    counters_.powered += powered_ / 1000;
+    powered_ %= 1000;
+
+    if (Now - savedAt_ >= STATS_SAVE_INTERVAL)
+        Save();
+
+    // One byte per loop: the eeprom takes 3.3 ms per byte, by the next loop the write is done
+    if (IsSaving())
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(&saving_);
+        EEPROM.update(SlotAddress(saveSlot_) + savePosition_, bytes[savePosition_]);
+        if (++savePosition_ == sizeof(Counters))
+            saveSlot_ = !saveSlot_;
+    }
+}
+
+void EnergyMeter::SetBrewing(bool IsBrewing, unsigned long Now) noexcept
+{
+    if (IsBrewing)
+        brewingSince_ = Now ? Now : 1;
+    else if (brewingSince_)
+    {
+        if (Now - brewingSince_ >= STATS_MIN_SHOT_TIME)
+            ++counters_.shots;
+        brewingSince_ = 0;
+    }
+}
+
+void EnergyMeter::Save() noexcept
+{
+    savedAt_ = lastUpdateAt_;
+    // A save still running goes on with the newer values, its slot only becomes valid with the last byte
+    ++counters_.sequence;
+    counters_.checksum = Checksum(counters_);
+    saving_ = counters_;
+    savePosition_ = 0;
+}
+
+unsigned long EnergyMeter::Energy() const noexcept
+{
+    unsigned long energy = 0;
+    for (uint8_t usage = 0; usage < USAGES; ++usage)
+        energy += counters_.energy[usage];
+    return energy;
+}
+
+uint8_t EnergyMeter::Checksum(const Counters& Counters) noexcept
+{
+    // Erased eeprom (0xFF) must not pass, so start from a seed
+    uint8_t checksum = 0xA5;
+    const auto end = reinterpret_cast<const uint8_t*>(&Counters.checksum);
+    for (auto byte = reinterpret_cast<const uint8_t*>(&Counters); byte < end; ++byte)
+        checksum = (checksum << 1 | checksum >> 7) ^ *byte;
+    return checksum;
+}
+
+void EnergyMeter::StartDay(uint16_t Day) noexcept
+{
+    // A clock set back keeps counting on today, a day far ahead clears everything
+    const uint16_t shift = Day > counters_.day ? Day - counters_.day : 0;
+    for (int8_t i = STATS_DAYS - 1; i >= 0; --i)
+        counters_.days[i] = i >= shift ? counters_.days[i - shift] : 0;
+    counters_.day = Day;
+}
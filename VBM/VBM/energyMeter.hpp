@@ -0,0 +1,95 @@
+#ifndef __ENERGY_METER_HPP
+#define __ENERGY_METER_HPP
+
+#include <EEPROM.h>
+
+#include "settings.hpp"
+
+// Meters the heater energy (SSR on-time weighted by HEATER_WATTAGE) per machine usage and per day, the heater and
+// pump on-times, the shots and the powered time. The counters are kept in two alternating eeprom slots at
+// STATS_EEPROM with a sequence number and a checksum, so a reset during a save falls back to the slot before.
+// A save only happens every STATS_SAVE_INTERVAL and when the machine is turned off. It writes one byte per loop
+// and skips bytes that did not change, so it neither blocks the loop nor wears the eeprom.
+class EnergyMeter final
+{
+  public:
+    enum class Usage : uint8_t
+    {
+        HeatUp,  // heating up or cooling down to a new setpoint
+        Idle,    // holding brew temperature
+        Steam,   // holding steam temperature
+        Sleep    // holding the eco setpoint
+    };
+    static constexpr const uint8_t USAGES = 4;
+
+    EnergyMeter() noexcept;
+
+    // Loads the newest valid slot, starts from zero if there is none
+    void Begin() noexcept;
+
+    // Integrates the time since the last call. Power: heater power from 0 to 1, Day: days since the unix epoch.
+    // Also writes the next byte of a running save.
+    void Update(double Power, bool PumpOn, Usage Usage, uint16_t Day, unsigned long Now) noexcept;
+
+    // Counts a shot when the lever was down for at least STATS_MIN_SHOT_TIME, shorter is a flush
+    void SetBrewing(bool IsBrewing, unsigned long Now) noexcept;
+
+    // Starts a save of the counters, Update writes it
+    void Save() noexcept;
+
+    // Whether a save is still being written
+    bool IsSaving() const noexcept { return savePosition_ < sizeof(Counters); }
+
+    // Heater energy in Wh
+    unsigned long Energy(Usage Usage) const noexcept { return counters_.energy[static_cast<uint8_t>(Usage)]; }
+    unsigned long Energy() const noexcept;
+    // Heater energy in Wh of a day, 0 is today, up to STATS_DAYS - 1
+    unsigned int DayEnergy(uint8_t DaysAgo) const noexcept { return counters_.days[DaysAgo]; }
+
+    // Times in seconds
+    unsigned long HeaterOnTime() const noexcept { return counters_.heaterOn; }
+    unsigned long PumpOnTime() const noexcept { return counters_.pumpOn; }
+    unsigned long PoweredTime() const noexcept { return counters_.powered; }
+
+    unsigned long Shots() const noexcept { return counters_.shots; }
+
+  private:
+    // Largest first, so there is no padding on the host either that the checksum would cover
+    struct Counters
+    {
+        uint32_t energy[USAGES];
+        uint32_t heaterOn;
+        uint32_t pumpOn;
+        uint32_t powered;
+        uint32_t shots;
+        uint16_t sequence;  // of the save, the slot with the higher one is newer
+        uint16_t day;       // the day of days[0]
+        uint16_t days[STATS_DAYS];
+        uint8_t checksum;
+    };
+    static_assert(STATS_EEPROM + 2 * sizeof(Counters) <= FLIGHT_RECORDER_EEPROM,
+                  "energy meter runs into the flight recorder eeprom");
+
+    static uint8_t Checksum(const Counters& Counters) noexcept;
+    static unsigned int SlotAddress(uint8_t Slot) noexcept { return STATS_EEPROM + Slot * sizeof(Counters); }
+
+    // Moves the days on to Day
+    void StartDay(uint16_t Day) noexcept;
+
+    Counters counters_;
+    // Below the resolution of the counters
+    double energy_[USAGES];  // Ws
+    double heaterOn_;        // s
+    unsigned long pumpOn_;   // ms
+    unsigned long powered_;  // ms
+
+    unsigned long lastUpdateAt_;
+    unsigned long brewingSince_;  // 0 while the lever is up
+    unsigned long savedAt_;
+
+    Counters saving_;  // copy of the counters being written
+    uint8_t saveSlot_;
+    uint8_t savePosition_;  // next byte of saving_ to write, sizeof(Counters) when done
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "etaEstimator.hpp"
+
+EtaEstimator::EtaEstimator() noexcept
+    : duty_{0},
+      lastSampleAt_{0},
+      learnedAt_{0},
+      heatingRate_{ETA_DEFAULT_HEATING_RATE},
+      coolingRate_{ETA_DEFAULT_COOLING_RATE},
+      settleTime_{ETA_DEFAULT_SETTLE_TIME},
+      enteredAt_{0},
+      wasReady_{false},
+      eta_{0}
+{
+}
+
+void EtaEstimator::Update(double Temperature, double Setpoint, double Power, const Readiness& Readiness,
+                          unsigned long Now) noexcept
+{
+    // The SSR may switch within a PID window, average over one
+    const double dt = Now - lastSampleAt_;
+    lastSampleAt_ = Now;
+    duty_ += (Power - duty_) * dt / (WINDOW_SIZE + dt);
+
+    const double low = Setpoint - IS_READY_RANGE;
+    const double high = Setpoint + IS_READY_RANGE;
+    if (Now - learnedAt_ >= READY_SLOPE_INTERVAL)
+    {
+        learnedAt_ = Now;
+        const double slope = Readiness.Slope();
+        // Only learn while the PID drives hard, near the setpoint the slope says more about the PID than the boiler
+        if (Temperature < low && duty_ >= ETA_MIN_LEARNING_DUTY && slope > 0)
+            heatingRate_ += (slope / duty_ - heatingRate_) * ETA_LEARNING_RATE;
+        else if (Temperature > high && duty_ < 1.0 - ETA_MIN_LEARNING_DUTY && slope < 0)
+            coolingRate_ += (-slope - coolingRate_) * ETA_LEARNING_RATE;
+    }
+
+    // Learn how long settling took from entering the range, only when it was entered from outside
+    const bool inRange = low < Temperature && Temperature < high;
+    if (!inRange)
+        enteredAt_ = 0;
+    else if (!enteredAt_)
+        enteredAt_ = Now ? Now : 1;
+    if (Readiness.IsReady() && !wasReady_ && enteredAt_)
+        settleTime_ += static_cast<long>((Now - enteredAt_) - settleTime_) * ETA_LEARNING_RATE;
+    wasReady_ = Readiness.IsReady();
+
+    if (Setpoint <= 0 || Readiness.IsReady())
+        eta_ = 0;
+    else if (!inRange)
+        eta_ = Predict(Temperature, Setpoint);
+    else
+    {
+        // Readiness needs at least its hold time, usually the rest of the settling takes longer
+        const unsigned long settled = enteredAt_ ? Now - enteredAt_ : 0;
+        const unsigned long settling = settled < settleTime_ ? settleTime_ - settled : 0;
+        const unsigned long hold = Readiness.TimeToReady(Now);
+        eta_ = (settling > hold ? settling : hold) / 1000;
+    }
+}
+
+unsigned long EtaEstimator::Predict(double Temperature, double Setpoint) const noexcept
+{
+    const double low = Setpoint - IS_READY_RANGE;
+    const double high = Setpoint + IS_READY_RANGE;
+    if (Temperature < low)
+        return static_cast<unsigned long>((low - Temperature) / heatingRate_) + settleTime_ / 1000;
+    if (Temperature > high)
+        return static_cast<unsigned long>((Temperature - high) / coolingRate_) + settleTime_ / 1000;
+    return settleTime_ / 1000;
+}
@@ -0,0 +1,55 @@
+#ifndef __ETA_ESTIMATOR_HPP
+#define __ETA_ESTIMATOR_HPP
+
+#include "readiness.hpp"
+#include "settings.hpp"
+
+// Predicts the seconds until the heater is ready: the distance to the range of IS_READY_RANGE divided by the rate
+// the boiler heats or cools, plus the time it takes to settle in the range until Readiness is satisfied.
+// The plant is reduced to two learned rates and the learned settling time. The heating rate at full power comes from
+// the observed slope divided by the SSR duty cycle while heating up, which covers a cold start, brew to steam and the
+// recovery after a shot alike.
+// The cooling rate is the slope with the SSR off, e.g. on the way from steam back to brew temperature.
+class EtaEstimator final
+{
+  public:
+    EtaEstimator() noexcept;
+
+    // Feeds a sample with the current heater power from 0 to 1 and the Readiness for the slope
+    void Update(double Temperature, double Setpoint, double Power, const Readiness& Readiness,
+                unsigned long Now) noexcept;
+
+    // Seconds until ready, 0 if ready or the heater is off
+    unsigned long Eta() const noexcept { return eta_; }
+
+    // Seconds it would take from Temperature to be ready at Setpoint with the learned rates, e.g. to wake up
+    unsigned long Predict(double Temperature, double Setpoint) const noexcept;
+
+    // Learned heating rate at full power in degrees per second
+    double HeatingRate() const noexcept { return heatingRate_; }
+    // Starts from a rate learned before, e.g. saved in eeprom
+    void SetHeatingRate(double Rate) noexcept
+    {
+        if (Rate > 0)
+            heatingRate_ = Rate;
+    }
+
+    // Learned cooling rate with the SSR off in degrees per second, positive
+    double CoolingRate() const noexcept { return coolingRate_; }
+
+    // Learned time in milliseconds from entering the range to being ready
+    unsigned long SettleTime() const noexcept { return settleTime_; }
+
+  private:
+    double duty_;  // low pass filtered SSR duty cycle, 0 to 1
+    unsigned long lastSampleAt_;
+    unsigned long learnedAt_;  // the slope only changes every READY_SLOPE_INTERVAL, learn once per interval
+    double heatingRate_;
+    double coolingRate_;
+    unsigned long settleTime_;
+    unsigned long enteredAt_;  // millis() the temperature entered the range, 0 while outside
+    bool wasReady_;
+    unsigned long eta_;
+};
+
+#endif
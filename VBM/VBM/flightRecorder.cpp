@@ -0,0 +1,121 @@
+#include "flightRecorder.hpp"
+
+#ifdef __AVR__
+#include <avr/wdt.h>
+#define NOINIT __attribute__((section(".noinit")))
+#else
+#define NOINIT
+// MCUSR bits of the ATmega328P
+#define PORF 0
+#define BORF 2
+#define WDRF 3
+#endif
+
+static_assert(FLIGHT_RECORDER_EEPROM + 4 + FLIGHT_RECORDER_SIZE * sizeof(FlightRecorder::Entry) <= 1024,
+              "flight recorder does not fit into the eeprom");
+
+namespace
+{
+// Kept in .noinit, so the recording of the run before a reset is still there at boot
+struct Recording
+{
+    uint16_t magic;
+    uint8_t head;  // where the next entry goes
+    uint8_t count;
+    FlightRecorder::Entry entries[FLIGHT_RECORDER_SIZE];
+};
+Recording recording NOINIT;
+
+constexpr const uint16_t RECORDING_MAGIC = 0x5EC0;
+
+uint8_t resetFlags NOINIT;
+
+bool IsRecordingValid()
+{
+    return recording.magic == RECORDING_MAGIC && recording.head < FLIGHT_RECORDER_SIZE &&
+           recording.count <= FLIGHT_RECORDER_SIZE;
+}
+}  // namespace
+
+#ifdef __AVR__
+// Runs before .bss is cleared and before any constructor. The watchdog stays enabled after a watchdog reset and must
+// be turned off before it fires again during startup.
+void CaptureResetFlags() __attribute__((naked, used, section(".init3")));
+void CaptureResetFlags()
+{
+    resetFlags = MCUSR;
+    // Optiboot clears MCUSR and hands the flags over in r2
+    if (!resetFlags)
+        __asm volatile("mov %0, r2" : "=r"(resetFlags));
+    MCUSR = 0;
+    wdt_disable();
+}
+
+uint8_t FlightRecorder::ResetFlags() noexcept { return resetFlags; }
+#else
+uint8_t FlightRecorder::ResetFlags() noexcept { return 0; }
+#endif
+
+void FlightRecorder::Begin(uint8_t ResetFlags) noexcept
+{
+    resetFlags = ResetFlags;
+    const bool watchdog = ResetFlags & (1 << WDRF);
+    const bool brownOut = ResetFlags & (1 << BORF);
+    const bool powerOn = ResetFlags & (1 << PORF);
+    // After power on the RAM holds garbage that may look valid by chance
+    if (powerOn || !IsRecordingValid())
+    {
+        recording.magic = RECORDING_MAGIC;
+        recording.head = 0;
+        recording.count = 0;
+    }
+    else if (watchdog || brownOut)
+        Persist(watchdog ? Cause::Watchdog : Cause::BrownOut);
+
+    Record(Kind::Reset, ResetFlags);
+}
+
+void FlightRecorder::Record(Kind Kind, uint8_t Data, int16_t Value) noexcept
+{
+    recording.entries[recording.head] = Entry{static_cast<uint16_t>(millis() / 1000), Kind, Data, Value};
+    recording.head = (recording.head + 1) % FLIGHT_RECORDER_SIZE;
+    if (recording.count < FLIGHT_RECORDER_SIZE)
+        ++recording.count;
+}
+
+void FlightRecorder::Persist(Cause Cause) noexcept
+{
+    // update only writes bytes that changed, which saves time and wear when the same incident is saved again
+    EEPROM.update(FLIGHT_RECORDER_EEPROM, EEPROM_MAGIC);
+    EEPROM.update(FLIGHT_RECORDER_EEPROM + 1, static_cast<uint8_t>(Cause));
+    EEPROM.update(FLIGHT_RECORDER_EEPROM + 2, resetFlags);
+    EEPROM.update(FLIGHT_RECORDER_EEPROM + 3, recording.count);
+    for (uint8_t i = 0; i < recording.count; ++i)
+    {
+        const uint8_t position = (recording.head + FLIGHT_RECORDER_SIZE - recording.count + i) % FLIGHT_RECORDER_SIZE;
+        EEPROM.put(FLIGHT_RECORDER_EEPROM + HEADER_SIZE + i * sizeof(Entry), recording.entries[position]);
+    }
+}
+
+FlightRecorder::Cause FlightRecorder::SavedCause() noexcept
+{
+    if (EEPROM.read(FLIGHT_RECORDER_EEPROM) != EEPROM_MAGIC)
+        return Cause::None;
+    return static_cast<Cause>(EEPROM.read(FLIGHT_RECORDER_EEPROM + 1));
+}
+
+uint8_t FlightRecorder::SavedResetFlags() noexcept { return EEPROM.read(FLIGHT_RECORDER_EEPROM + 2); }
+
+uint8_t FlightRecorder::SavedCount() noexcept
+{
+    if (SavedCause() == Cause::None)
+        return 0;
+    const uint8_t count = EEPROM.read(FLIGHT_RECORDER_EEPROM + 3);
+    return count <= FLIGHT_RECORDER_SIZE ? count : 0;
+}
+
+FlightRecorder::Entry FlightRecorder::SavedEntry(uint8_t Index) noexcept
+{
+    Entry entry;
+    return EEPROM.get(FLIGHT_RECORDER_EEPROM + HEADER_SIZE + Index * sizeof(Entry), entry);
+}
@@ -0,0 +1,65 @@
+#ifndef __FLIGHT_RECORDER_HPP
+#define __FLIGHT_RECORDER_HPP
+
+#include <EEPROM.h>
+
+#include "settings.hpp"
+
+// Records the last FLIGHT_RECORDER_SIZE state transitions, temperatures, button presses and serial commands in a
+// RAM ring that survives a reset. When the machine goes into error, or at boot after a watchdog or brown-out reset,
+// the ring is written to the reserved eeprom region at FLIGHT_RECORDER_EEPROM, where the blackbox command reads it.
+class FlightRecorder final
+{
+  public:
+    enum class Kind : uint8_t
+    {
+        Reset,        // data: reset flags (MCUSR)
+        Transition,   // data: from + 1 in the high nibble, to + 1 in the low nibble; value: event
+        Temperature,  // data: machine state + 1; value: boiler temperature in 1/10 degrees
+        Button,       // data: Button::Command
+        Command,      // data: Communicator::Command
+        Fault         // data: Supervisor::Fault; value: boiler temperature in 1/10 degrees
+    };
+
+    // Why the recording was saved
+    enum class Cause : uint8_t
+    {
+        None = 0,
+        Error,
+        Watchdog,
+        BrownOut
+    };
+
+    struct Entry
+    {
+        uint16_t at;  // seconds since boot
+        Kind kind;
+        uint8_t data;
+        int16_t value;
+    };
+
+    // Flags of the last reset as found in MCUSR before the bootloader or anything else cleared them
+    static uint8_t ResetFlags() noexcept;
+
+    // Call once at boot: saves the recording of a run ended by the watchdog or a brown-out and starts a new one
+    static void Begin(uint8_t ResetFlags) noexcept;
+
+    static void Record(Kind Kind, uint8_t Data, int16_t Value = 0) noexcept;
+
+    // Writes the recording to eeprom. Blocks for up to a few hundred milliseconds, only call it with the heater off.
+    static void Persist(Cause Cause) noexcept;
+
+    // The recording last saved to eeprom, Cause::None if there is none
+    static Cause SavedCause() noexcept;
+    static uint8_t SavedResetFlags() noexcept;
+    static uint8_t SavedCount() noexcept;
+    // Saved entry, 0 is the oldest
+    static Entry SavedEntry(uint8_t Index) noexcept;
+
+  private:
+    // Eeprom layout at FLIGHT_RECORDER_EEPROM: magic, cause, reset flags, count, entries oldest first
+    static constexpr const uint8_t EEPROM_MAGIC = 0xB7;
+    static constexpr const uint8_t HEADER_SIZE = 4;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "flowMeter.hpp"
+
+volatile uint16_t FlowMeter::pulses_ = 0;
+volatile unsigned long FlowMeter::pulseAt_ = 0;
+volatile bool FlowMeter::level_ = false;
+uint16_t FlowMeter::measuredPulses_ = 0;
+unsigned long FlowMeter::measuredAt_ = 0;
+unsigned long FlowMeter::updatedAt_ = 0;
+double FlowMeter::flow_ = 0;
+
+#ifdef __AVR__
+static_assert(FLOW_METER_PIN >= 0 && FLOW_METER_PIN <= 7, "the flow meter interrupt expects a pin of PORTD");
+
+ISR(PCINT2_vect) { FlowMeter::PinChange(); }
+#endif
+
+void FlowMeter::Begin() noexcept
+{
+    // Hall sensors have an open collector output
+    FlowMeterPin::Init(true);
+    level_ = FlowMeterPin::Read();
+#ifdef __AVR__
+    *digitalPinToPCMSK(FLOW_METER_PIN) |= _BV(digitalPinToPCMSKbit(FLOW_METER_PIN));
+    PCICR |= _BV(digitalPinToPCICRbit(FLOW_METER_PIN));
+#endif
+}
+
+void FlowMeter::Reset() noexcept
+{
+    noInterrupts();
+    pulses_ = 0;
+    interrupts();
+    measuredPulses_ = 0;
+    measuredAt_ = micros();
+    flow_ = 0;
+}
+
+void FlowMeter::Update(unsigned long Now) noexcept
+{
+    if (Now - updatedAt_ < FLOW_INTERVAL)
+        return;
+    updatedAt_ = Now;
+
+    uint16_t pulses = 0;
+    unsigned long pulseAt = 0;
+    Read(pulses, pulseAt);
+    if (pulses != measuredPulses_)
+    {
+        // After a pause the time since the last pulse says nothing about the flow, measure from this pulse on
+        const unsigned long interval = pulseAt - measuredAt_;
+        if (interval <= FLOW_TIMEOUT * 1000UL)
+            flow_ = (pulses - measuredPulses_) / FLOW_METER_PULSES_PER_ML * 1e6 / interval;
+        measuredPulses_ = pulses;
+        measuredAt_ = pulseAt;
+    }
+    else if (micros() - measuredAt_ > FLOW_TIMEOUT * 1000UL)
+        flow_ = 0;
+}
+
+double FlowMeter::Volume() noexcept
+{
+    uint16_t pulses = 0;
+    unsigned long pulseAt = 0;
+    Read(pulses, pulseAt);
+    return pulses / FLOW_METER_PULSES_PER_ML;
+}
+
+void FlowMeter::PinChange() noexcept
+{
+    // The interrupt fires on both edges, only rising ones count
+    const bool level = FlowMeterPin::Read();
+    if (level && !level_)
+    {
+        ++pulses_;
+        pulseAt_ = micros();
+    }
+    level_ = level;
+}
+
+void FlowMeter::Read(uint16_t& Pulses, unsigned long& PulseAt) noexcept
+{
+    noInterrupts();
+    Pulses = pulses_;
+    PulseAt = pulseAt_;
+    interrupts();
+}
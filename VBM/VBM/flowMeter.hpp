@@ -0,0 +1,46 @@
+#ifndef __FLOW_METER_HPP
+#define __FLOW_METER_HPP
+
+#include "pins.hpp"
+#include "settings.hpp"
+
+// Measures the water pumped into the group with a hall effect flow meter on FLOW_METER_PIN. The pin change
+// interrupt counts the pulses and stamps the last one with micros(). Update in the loop turns the count into ml and
+// the flow into ml/s from the pulses between two stamps, so the flow is exact to the pulse no matter how long the
+// loop takes, even with only a few pulses per second at espresso flow.
+class FlowMeter final
+{
+  public:
+    // Configures the pin and enables its pin change interrupt
+    static void Begin() noexcept;
+
+    // Starts a new shot: volume and flow from 0
+    static void Reset() noexcept;
+
+    // Measures the flow over the pulses since the last call, call in the loop
+    static void Update(unsigned long Now) noexcept;
+
+    // Volume in ml since the last Reset
+    static double Volume() noexcept;
+
+    // Flow in ml/s, 0 once no pulse came for FLOW_TIMEOUT
+    static double Flow() noexcept { return flow_; }
+
+    // Counts a rising edge of the flow meter, called by the pin change interrupt
+    static void PinChange() noexcept;
+
+  private:
+    // Takes count and time of the last pulse at once
+    static void Read(uint16_t& Pulses, unsigned long& PulseAt) noexcept;
+
+    static volatile uint16_t pulses_;
+    static volatile unsigned long pulseAt_;  // micros() of the last pulse
+    static volatile bool level_;             // last pin level seen by the interrupt
+
+    static uint16_t measuredPulses_;      // pulses at the last flow measurement
+    static unsigned long measuredAt_;     // micros() of the last pulse of the last flow measurement
+    static unsigned long updatedAt_;
+    static double flow_;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#include "groupCascade.hpp"
+
+GroupCascade::GroupCascade() noexcept : integral_{0}, trim_{0}, updatedAt_{0}, started_{false} {}
+
+void GroupCascade::Reset() noexcept
+{
+    integral_ = 0;
+    trim_ = 0;
+    started_ = false;
+}
+
+double GroupCascade::Update(double GroupTemperature, double Setpoint, unsigned long Now) noexcept
+{
+    const double error = Setpoint - GroupTemperature;
+    const double dt = started_ ? (Now - updatedAt_) / 1000.0 : 0;
+    updatedAt_ = Now;
+    started_ = true;
+
+    // The integral only winds up as far as the trim can go
+    integral_ = constrain(integral_ + GROUP_KI * error * dt, -GROUP_CASCADE_RANGE, GROUP_CASCADE_RANGE);
+    trim_ = constrain(GROUP_KP * error + integral_, -GROUP_CASCADE_RANGE, GROUP_CASCADE_RANGE);
+    return trim_;
+}
@@ -0,0 +1,31 @@
+#ifndef __GROUP_CASCADE_HPP
+#define __GROUP_CASCADE_HPP
+
+#include "settings.hpp"
+
+// Outer loop of a cascade on the boiler PID: trims the boiler setpoint until the group head, the mass the water
+// passes last, sits at its own setpoint. The brew setpoint stays the feed forward, the trim only makes up what the
+// boiler to group loss differs from it, so a fixed offset between boiler and cup no longer has to be guessed. A slow
+// PI, the group takes minutes to follow the boiler. Enabled with SETPOINT_GROUP_TEMP, see Heater, without a group
+// sensor it runs on the estimate of GroupObserver.
+class GroupCascade final
+{
+  public:
+    GroupCascade() noexcept;
+
+    // Starts over without trim
+    void Reset() noexcept;
+
+    // Takes a new group reading and returns the trim for the boiler setpoint, within +-GROUP_CASCADE_RANGE
+    double Update(double GroupTemperature, double Setpoint, unsigned long Now) noexcept;
+
+    double Trim() const noexcept { return trim_; }
+
+  private:
+    double integral_;
+    double trim_;
+    unsigned long updatedAt_;
+    bool started_;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "groupObserver.hpp"
+
+namespace
+{
+constexpr const uint8_t SHARE_BITS = 24;  // fraction bits of a share per step, small ones are around 1e-4
+
+constexpr int32_t Share(double Value) { return static_cast<int32_t>(Value * (1L << SHARE_BITS) + 0.5); }
+// Share of a difference a node follows in one step with the time constant Seconds
+constexpr int32_t PerStep(double Seconds) { return Share(OBSERVER_INTERVAL / 1000.0 / Seconds); }
+
+constexpr const int32_t GROUP_HEAT = PerStep(GROUP_HEAT_TIME);
+// What heats the group cools the boiler, by the ratio of their capacities
+constexpr const int32_t BOILER_TO_GROUP = PerStep(GROUP_HEAT_TIME / GROUP_CAPACITY_RATIO);
+constexpr const int32_t GROUP_LOSS = PerStep(GROUP_LOSS_TIME);
+constexpr const int32_t GROUP_FLUSH = PerStep(GROUP_FLUSH_TIME);
+constexpr const int32_t BOILER_LOSS = PerStep(BOILER_LOSS_TIME);
+constexpr const int32_t BOILER_FLUSH = PerStep(BOILER_FLUSH_TIME);
+constexpr const int32_t GAIN_BOILER = Share(OBSERVER_GAIN_BOILER);
+constexpr const int32_t GAIN_GROUP = Share(OBSERVER_GAIN_GROUP);
+
+int32_t Scale(int32_t Value, int32_t Factor)
+{
+    return static_cast<int32_t>(static_cast<int64_t>(Value) * Factor >> SHARE_BITS);
+}
+}  // namespace
+
+GroupObserver::GroupObserver() noexcept : boiler_{0}, group_{0}, steppedAt_{0} {}
+
+void GroupObserver::Reset(double Boiler, double Group, unsigned long Now) noexcept
+{
+    boiler_ = ToFixed(Boiler);
+    group_ = ToFixed(Group);
+    steppedAt_ = Now;
+}
+
+void GroupObserver::Update(double Boiler, double Power, bool Pumping, double HeatingRate, unsigned long Now) noexcept
+{
+    steppedAt_ = Now;
+    const int32_t ambient = ToFixed(AMBIENT_TEMP);
+    const int32_t boilerToGroup = boiler_ - group_;
+
+    // Predict, both nodes from the state of the last step
+    int32_t boiler = boiler_ + ToFixed(HeatingRate * Power * OBSERVER_INTERVAL / 1000.0);
+    boiler -= Scale(boilerToGroup, BOILER_TO_GROUP) + Scale(boiler_ - ambient, BOILER_LOSS);
+    int32_t group = group_ + Scale(boilerToGroup, GROUP_HEAT) - Scale(group_ - ambient, GROUP_LOSS);
+    if (Pumping)
+    {
+        boiler -= Scale(boiler_ - ambient, BOILER_FLUSH);
+        group += Scale(boilerToGroup, GROUP_FLUSH);
+    }
+
+    // Correct with how far the reading is off the prediction
+    const int32_t error = ToFixed(Boiler) - boiler;
+    boiler_ = boiler + Scale(error, GAIN_BOILER);
+    group_ = group + Scale(error, GAIN_GROUP);
+}
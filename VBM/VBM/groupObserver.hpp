@@ -0,0 +1,47 @@
+#ifndef __GROUP_OBSERVER_HPP
+#define __GROUP_OBSERVER_HPP
+
+#include "settings.hpp"
+
+// Estimates the group head temperature from the boiler alone, for machines without a group sensor. Two nodes: the
+// boiler water is heated by the SSR and cools to the room, the group follows it through its mount and cools to the
+// room as well. While the pump runs, fresh water cools the boiler and the hot water flushes the group towards the
+// boiler temperature. Every OBSERVER_INTERVAL the model takes one step and the boiler reading corrects both nodes by
+// the fixed gains of a steady state Kalman filter, so no covariances are carried along. Fixed point in 1/65536
+// degree, the products of a step are the only 64 bit operations. With a group sensor the estimate runs anyway and
+// the two can be compared to tune the model.
+class GroupObserver final
+{
+  public:
+    GroupObserver() noexcept;
+
+    // Starts both nodes from a reading, Group is the boiler's as well without a better one
+    void Reset(double Boiler, double Group, unsigned long Now) noexcept;
+
+    bool IsDue(unsigned long Now) const noexcept { return Now - steppedAt_ >= OBSERVER_INTERVAL; }
+
+    // One step with the last boiler reading, the heater power from 0 to 1 over the last step, whether the pump ran
+    // and the heating rate at full power in degrees/s
+    void Update(double Boiler, double Power, bool Pumping, double HeatingRate, unsigned long Now) noexcept;
+
+    // Estimated temperature of the boiler water, the reading without its noise
+    double Boiler() const noexcept { return ToDegrees(boiler_); }
+
+    // Estimated temperature of the group head
+    double Group() const noexcept { return ToDegrees(group_); }
+
+  private:
+    static constexpr const uint8_t FRACTION_BITS = 16;  // of a temperature
+
+    static int32_t ToFixed(double Degrees) noexcept
+    {
+        return static_cast<int32_t>(Degrees * (1L << FRACTION_BITS));
+    }
+    static double ToDegrees(int32_t Value) noexcept { return static_cast<double>(Value) / (1L << FRACTION_BITS); }
+
+    int32_t boiler_;
+    int32_t group_;
+    unsigned long steppedAt_;
+};
+
+#endif
@@ -1,84 +1,196 @@
 #include "heater.hpp"
 
 Heater::Heater()
-    : isReady_{false},
-      heaterState_{State::Off},
+    : heaterState_{State::Off},
       currentTemperature_{0},
-      thermocouple_(new Adafruit_MAX31865(BOILER_TEMP_CS_PIN)),
+      setpoint_{0},
       relayState_(false),
+      boilerRtd_(BOILER_TEMP_CS_PIN, 0),
+      groupRtd_(GROUP_TEMP_CS_PIN, GROUP_TEMP_INTERVAL),
+      groupTemperature_{0},
+      cascade_(),
+      observer_(),
+      pid_(&currentTemperature_, &setpoint_, &relayState_, WINDOW_SIZE, &KP, &KI, &KD),
       windowStartTime_{millis()},
-      setpoint_{0}
+      readiness_(),
+      eta_(),
+      brewing_{false},
+      steamSettled_{false},
+      steamBoost_()
 {
-    pinMode(BOILER_SSR_PIN, OUTPUT);
-    digitalWrite(BOILER_SSR_PIN, LOW);
-
-    thermocouple_->begin(MAX31865_TYPE);
-
-    pid_ = new StuPIDRelay(&currentTemperature_, &setpoint_, &relayState_, WINDOW_SIZE, &KP, &KI, &KD);
+    BoilerSsrPin::Init();
 }
 
-Heater::~Heater()
+bool Heater::Begin() noexcept
 {
-    delete thermocouple_;
-    delete pid_;
+#if HEATER_OUTPUT_SIGMA_DELTA
+    SigmaDelta::Begin();
+#endif
+    // The MAX31865 answers or not within one conversion, a missing one reads as fault or out of range
+    boilerRtd_.Begin();
+    UpdateTemperature();
+    if (groupRtd_.Begin())
+        UpdateGroupTemperature();
+    observer_.Reset(currentTemperature_, groupRtd_.IsPresent() ? groupTemperature_ : currentTemperature_, millis());
+    return Supervisor::Tripped() == Supervisor::Fault::None;
 }
 
 void Heater::SetHeaterTo(State HeaterState) noexcept
 {
     // On state change, set to not ready
     if (heaterState_ != HeaterState)
-        isReady_ = false;
+    {
+        readiness_.Restart();
+        steamSettled_ = false;
+        cascade_.Reset();
+    }
 
     heaterState_ = HeaterState;
     switch (heaterState_)
     {
         case State::BrewTemp:
-            setpoint_ = SETPOINT_BREW_TEMP;
+            setpoint_ = BrewSetpoint();
             break;
 
+        // Setpoints from eeprom may predate MAX_SETPOINT
         case State::SteamTemp:
-            setpoint_ = SETPOINT_STEAM_TEMP;
+            setpoint_ = SETPOINT_STEAM_TEMP < MAX_SETPOINT ? SETPOINT_STEAM_TEMP : MAX_SETPOINT;
+            break;
+
+        case State::EcoTemp:
+            setpoint_ = SETPOINT_ECO_TEMP < MAX_SETPOINT ? SETPOINT_ECO_TEMP : MAX_SETPOINT;
             break;
         default:
         case State::Off:
             setpoint_ = 0;
             break;
     }
-    LOG_HEATER(String("SetHeaterTo: ") + static_cast<int>(heaterState_) + " with setpoint: " + setpoint_)
+    LOG_HEATER("SetHeaterTo: {} with setpoint: {}", static_cast<int>(heaterState_), setpoint_)
 }
 
-bool Heater::IsReady() noexcept
+void Heater::Update() noexcept
 {
-    // Set isReady once for each stage
-    if (!isReady_)
-        isReady_ =
-            ((setpoint_ - IS_READY_RANGE) < currentTemperature_) && ((setpoint_ + IS_READY_RANGE) > currentTemperature_)
-                ? true
-                : false;
-    LOG_HEATER(String(">IsReady") + isReady_)
-    return isReady_;
+    // One SPI step per loop, the boiler's first. The chips convert at the same time, a step only starts a
+    // conversion or fetches the result, so the group fits in while the boiler conversion runs.
+    const auto now = millis();
+    if (boilerRtd_.IsDue(now))
+    {
+        if (boilerRtd_.Step(now))
+            UpdateTemperature();
+    }
+    else if (groupRtd_.IsPresent() && groupRtd_.IsDue(now) && groupRtd_.Step(now))
+        UpdateGroupTemperature();
+    if (observer_.IsDue(now))
+        UpdateGroupEstimate(now);
+    Boiler();
 }
 
 void Heater::UpdateTemperature()
 {
-    currentTemperature_ = thermocouple_->temperature(RNOMINAL, RREF);
-    LOG_HEATER(String(">temperature:") + currentTemperature_)
-    LOG_HEATER(String(">setpoint:") + setpoint_)
+    currentTemperature_ = boilerRtd_.Temperature();
+    // An open or shorted RTD reads as a wild temperature, the fault register tells. The next reading clears it.
+    const auto fault = boilerRtd_.Fault();
+    if (fault)
+    {
+        LOG_HEATER("MAX31865 fault {}", fault)
+    }
+    Supervisor::Sample(currentTemperature_, fault);
+    const auto now = millis();
+    readiness_.Update(currentTemperature_, setpoint_, now);
+    // The power of the last PID cycle, which heated the boiler up to this sample
+    eta_.Update(currentTemperature_, setpoint_, Power(), readiness_, now);
+
+    const bool steaming = heaterState_ == State::SteamTemp && !brewing_;
+    if (steaming && readiness_.IsReady())
+        steamSettled_ = true;
+    steamBoost_.Update(readiness_.Slope(), currentTemperature_, setpoint_, steaming, steamSettled_, now);
+    LOG_HEATER(">temperature:{}", currentTemperature_)
+    LOG_HEATER(">setpoint:{}", setpoint_)
+}
+
+void Heater::UpdateGroupTemperature() noexcept
+{
+    const bool valid = !groupRtd_.Fault();
+    if (valid)
+        groupTemperature_ = groupRtd_.Temperature();
+    LOG_HEATER(">group_temperature:{}", groupTemperature_)
+    TrimBrewSetpoint(groupTemperature_, valid, millis());
+}
+
+void Heater::UpdateGroupEstimate(unsigned long Now) noexcept
+{
+    // Held until the boiler reads right again
+    if (boilerRtd_.Fault())
+        return;
+    observer_.Update(currentTemperature_, Power(), PumpProfile::IsRunning(), eta_.HeatingRate(), Now);
+    LOG_HEATER(">group_estimate:{}", observer_.Group())
+    // A group sensor knows better
+    if (!groupRtd_.IsPresent())
+        TrimBrewSetpoint(observer_.Group(), true, Now);
+}
+
+void Heater::TrimBrewSetpoint(double GroupTemperature, bool Valid, unsigned long Now) noexcept
+{
+    if (heaterState_ != State::BrewTemp)
+        return;
+    if (Valid && SETPOINT_GROUP_TEMP > 0)
+        cascade_.Update(GroupTemperature, SETPOINT_GROUP_TEMP, Now);
+    else
+        cascade_.Reset();
+    setpoint_ = BrewSetpoint();
+}
+
+double Heater::BrewSetpoint() const noexcept
+{
+    const double setpoint = SETPOINT_BREW_TEMP + cascade_.Trim();
+    return setpoint < MAX_SETPOINT ? setpoint : MAX_SETPOINT;
 }
 
 void Heater::Boiler(void)
 {
     // For now I duplicated this code as the relayState_ will be switched from AutoPIDRelay
-    if (heaterState_ == State::Off)
+    if (heaterState_ == State::Off || Supervisor::Tripped() != Supervisor::Fault::None)
+    {
+#if HEATER_OUTPUT_SIGMA_DELTA
+        SigmaDelta::SetPower(0);
+#endif
+        BoilerSsrPin::Low();
+        LOG_HEATER(">heater_ssr:0")
+    }
+    else if (steamBoost_.Phase() == SteamBoost::Phase::Boosting)
     {
-        digitalWrite(BOILER_SSR_PIN, LOW);
-        LOG_HEATER(String(">heater_ssr:0"));
+        // Full power while the draw lasts, only held back at the raised setpoint
+        const bool heat = !DISABLE_HEATER && currentTemperature_ < SteamBoost::BoostSetpoint(setpoint_);
+#if HEATER_OUTPUT_SIGMA_DELTA
+        SigmaDelta::SetPower(heat ? 1 : 0);
+#else
+        relayState_ = heat;
+        BoilerSsrPin::Write(relayState_);
+#endif
+        LOG_HEATER(">heater_boost:{}", heat)
     }
     else
     {
-        pid_->run();
+        pid_.run();
+#if HEATER_OUTPUT_SIGMA_DELTA
+        // The PID output is the share of the window the relay would be on, which is the power as well
+        SigmaDelta::SetPower(DISABLE_HEATER ? 0 : pid_.getPulseValue());
+        LOG_HEATER(">heater_power:{}", pid_.getPulseValue())
+#else
         if (!DISABLE_HEATER)
-            digitalWrite(BOILER_SSR_PIN, relayState_);
-        LOG_HEATER(String(">heater_ssr:") + relayState_);
+            BoilerSsrPin::Write(relayState_);
+        LOG_HEATER(">heater_ssr:{}", relayState_)
+#endif
     }
 }
+
+double Heater::Power() const noexcept
+{
+    if (heaterState_ == State::Off)
+        return 0;
+#if HEATER_OUTPUT_SIGMA_DELTA
+    return SigmaDelta::Power();
+#else
+    return relayState_ ? 1 : 0;
+#endif
+}
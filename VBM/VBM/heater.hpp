@@ -1,13 +1,22 @@
 #ifndef __HEATER_HPP
 #define __HEATER_HPP
 
-#include <Adafruit_MAX31865.h>
 // Get this library here: https://github.com/nekowokaburu/StuPID
 // and copy it to your library directory. Maybe you'll need to update the
 // library manager in order to find it.
 #include <StuPID.hpp>
 
+#include "etaEstimator.hpp"
+#include "groupCascade.hpp"
+#include "groupObserver.hpp"
+#include "pins.hpp"
+#include "pumpProfile.hpp"
+#include "readiness.hpp"
+#include "rtdChannel.hpp"
+#include "sigmaDelta.hpp"
 #include "settings.hpp"
+#include "steamBoost.hpp"
+#include "supervisor.hpp"
 
 class Heater final
 {
@@ -16,46 +25,98 @@ class Heater final
     {
         Off,
         BrewTemp,
-        SteamTemp
+        SteamTemp,
+        EcoTemp
     };
 
+    // Only drives the SSR low, the sensor is set up by Begin
     Heater();
 
-    ~Heater();
+    // Sets up the MAX31865s and the output stage and takes the first sample, which the supervisor checks.
+    // Returns false if the boiler sensor is missing or faulty, the supervisor has tripped then. The group sensor is
+    // optional.
+    bool Begin() noexcept;
 
     double CurrentTemperature() const noexcept
     {
       return currentTemperature_;
     }
 
+    // Whether a group head sensor answered at Begin, and its last good reading
+    bool HasGroupSensor() const noexcept { return groupRtd_.IsPresent(); }
+    double GroupTemperature() const noexcept { return groupTemperature_; }
+
+    // Group temperature estimated from the boiler, see GroupObserver
+    double GroupEstimate() const noexcept { return observer_.Group(); }
+
     // Switch heater state and temperature regulation based on predefined values
     void SetHeaterTo(State HeaterState) noexcept;
 
-    // Gets whether the heater reached the heating range once
-    bool IsReady() noexcept;
+    // Gets whether the temperature settled at the setpoint, see Readiness
+    bool IsReady() const noexcept { return readiness_.IsReady(); }
 
-    // Update heater management, must be called in a loop
-    void Update() noexcept
-    {
-        UpdateTemperature();
-        Boiler();
-    }
+    // Confidence of the readiness from 0 to 100
+    uint8_t ReadyConfidence() const noexcept { return readiness_.Confidence(); }
+
+    // Seconds until ready, 0 if ready or off
+    unsigned long Eta() const noexcept { return eta_.Eta(); }
+
+    // Seconds it would take from the current temperature until ready at Setpoint
+    unsigned long EtaTo(double Setpoint) const noexcept { return eta_.Predict(currentTemperature_, Setpoint); }
+
+    // Learned heating rate at full power in degrees/s, see EtaEstimator
+    double HeatingRate() const noexcept { return eta_.HeatingRate(); }
+    void SetHeatingRate(double Rate) noexcept { eta_.SetHeatingRate(Rate); }
+
+    // The brew lever is down, a falling steam temperature is the pump then and not a steam draw
+    void SetBrewing(bool IsBrewing) noexcept { brewing_ = IsBrewing; }
+
+    // Steam draw detection and boost, see SteamBoost
+    SteamBoost& Boost() noexcept { return steamBoost_; }
+
+    // Power the boiler is heated with from 0 to 1, the relay state of the window or the sigma-delta power
+    double Power() const noexcept;
+
+    // Update heater management, must be called in a loop. Runs one step of the sensor readout, see RtdChannel
+    void Update() noexcept;
 
   private:
-    // Update the thermocouple readout
+    // Takes the new boiler reading over and hands it to the supervisor
     void UpdateTemperature();
 
+    // Takes the new group reading over and trims the brew setpoint with it
+    void UpdateGroupTemperature() noexcept;
+
+    // Steps the group estimate, which the brew setpoint is trimmed with if there is no group sensor
+    void UpdateGroupEstimate(unsigned long Now) noexcept;
+
+    // Trims the brew setpoint for the group to reach SETPOINT_GROUP_TEMP, see GroupCascade. An invalid group
+    // temperature leaves it untrimmed.
+    void TrimBrewSetpoint(double GroupTemperature, bool Valid, unsigned long Now) noexcept;
+
+    // Brew setpoint with the trim of the cascade
+    double BrewSetpoint() const noexcept;
+
     // Computes if the heater should be on or off for this loop cycle
     void Boiler(void);
 
     State heaterState_;
     double currentTemperature_;
     double setpoint_;
-    Adafruit_MAX31865* thermocouple_;
-    StuPIDRelay* pid_;
     bool relayState_;
+    RtdChannel boilerRtd_;
+    RtdChannel groupRtd_;
+    double groupTemperature_;
+    GroupCascade cascade_;
+    GroupObserver observer_;
+    // Only keeps pointers to the members above, which are constructed before it
+    StuPIDRelay pid_;
     unsigned long windowStartTime_;
-    bool isReady_;
+    Readiness readiness_;
+    EtaEstimator eta_;
+    bool brewing_;
+    bool steamSettled_;  // was ready at steam temperature since switching to it
+    SteamBoost steamBoost_;
 };
 
 #endif
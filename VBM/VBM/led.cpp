@@ -1,2 +1,150 @@
 #include "led.hpp"
 
+LED* LED::instance_ = nullptr;
+
+namespace
+{
+// Marks that no layer has a pattern
+constexpr const uint8_t NO_LAYER = 0xFF;
+}  // namespace
+
+LED::LED()
+    : layers_{},
+      active_{NO_LAYER},
+      step_{0},
+      mask_{0},
+      ticksLeft_{0},
+      extraTicksAccumulator_{0},
+      pwmCounter_{0},
+      brightness_{0},
+      ledOn_{false}
+{
+    LedPin::Init();
+    instance_ = this;
+    Ticker::Attach(&LED::Tick);
+}
+
+void LED::Show(Priority Priority, uint32_t Bits, uint8_t Length, unsigned int Period) noexcept
+{
+    if (!Length)
+    {
+        Clear(Priority);
+        return;
+    }
+    if (Length > 32)
+        Length = 32;
+    const unsigned int stepTicks = Period / Length;
+    const Layer layer = {Bits, Length, false, stepTicks ? stepTicks : 1, static_cast<uint8_t>(Period % Length)};
+    SetLayer(Priority, layer);
+}
+
+void LED::Breathe(Priority Priority, unsigned int Period) noexcept
+{
+    // Fade in and out in 2 * PWM_LEVELS brightness steps
+    const uint8_t steps = 2 * PWM_LEVELS;
+    const unsigned int stepTicks = Period / steps;
+    const Layer layer = {0, steps, true, stepTicks ? stepTicks : 1, static_cast<uint8_t>(Period % steps)};
+    SetLayer(Priority, layer);
+}
+
+void LED::Clear(Priority Priority) noexcept
+{
+    const Layer layer = {0, 0, false, 0, 0};
+    SetLayer(Priority, layer);
+}
+
+void LED::SetLayer(Priority Priority, const Layer& NewLayer) noexcept
+{
+    // Called every loop with the same pattern, only a change may restart the playback
+    auto& layer = layers_[static_cast<uint8_t>(Priority)];
+    if (layer.bits == NewLayer.bits && layer.length == NewLayer.length && layer.breathing == NewLayer.breathing &&
+        layer.stepTicks == NewLayer.stepTicks && layer.extraTicks == NewLayer.extraTicks)
+        return;
+    LOG_LED("Show: priority {} bits {} length {} breathing {}", static_cast<int>(Priority), NewLayer.bits,
+            NewLayer.length, NewLayer.breathing)
+
+    noInterrupts();
+    layer = NewLayer;
+    // A change below the shown priority stays hidden and must not disturb the running pattern
+    uint8_t highest = NO_LAYER;
+    for (int8_t i = 2; i >= 0; --i)
+        if (layers_[i].length)
+        {
+            highest = i;
+            break;
+        }
+    if (highest != active_ || highest == static_cast<uint8_t>(Priority))
+    {
+        active_ = highest;
+        Restart();
+    }
+    interrupts();
+}
+
+void LED::Restart() noexcept
+{
+    step_ = 0;
+    extraTicksAccumulator_ = 0;
+    pwmCounter_ = 0;
+    if (active_ == NO_LAYER)
+    {
+        ledOn_ = false;
+        LedPin::Low();
+        return;
+    }
+    mask_ = 1UL << (layers_[active_].length - 1);
+    StartStep();
+}
+
+void LED::Step() noexcept
+{
+    const auto& layer = layers_[active_];
+    if (++step_ == layer.length)
+    {
+        step_ = 0;
+        mask_ = 1UL << (layer.length - 1);
+    }
+    else
+        mask_ >>= 1;
+    StartStep();
+}
+
+void LED::StartStep() noexcept
+{
+    const auto& layer = layers_[active_];
+    ticksLeft_ = layer.stepTicks;
+    extraTicksAccumulator_ += layer.extraTicks;
+    if (extraTicksAccumulator_ >= layer.length)
+    {
+        extraTicksAccumulator_ -= layer.length;
+        ++ticksLeft_;
+    }
+    // Triangle from 1 up to PWM_LEVELS and back down for breathing
+    brightness_ = step_ < PWM_LEVELS ? step_ + 1 : 2 * PWM_LEVELS - step_;
+}
+
+void LED::Tick() noexcept
+{
+    LED* const led = instance_;
+    if (!led || led->active_ == NO_LAYER)
+        return;
+
+    if (--led->ticksLeft_ == 0)
+        led->Step();
+
+    bool on;
+    if (led->layers_[led->active_].breathing)
+    {
+        if (++led->pwmCounter_ == PWM_LEVELS)
+            led->pwmCounter_ = 0;
+        on = led->pwmCounter_ < led->brightness_;
+    }
+    else
+        on = led->layers_[led->active_].bits & led->mask_;
+
+    if (on != led->ledOn_)
+    {
+        led->ledOn_ = on;
+        LedPin::Write(on);
+    }
+}
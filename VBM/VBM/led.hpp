@@ -1,8 +1,13 @@
 #ifndef __LED_HPP
 #define __LED_HPP
 
+#include "pins.hpp"
 #include "settings.hpp"
+#include "ticker.hpp"
 
+// Plays blink patterns on the status led from the Ticker interrupt, so the timing does not depend on the main loop.
+// Patterns are set per priority; the highest priority that has a pattern is shown, e.g. an error overrides the
+// status pattern and the status comes back once the error is cleared.
 class LED
 {
 public:
@@ -21,34 +26,75 @@ public:
         Gallop = 0xA8        // 1010 1000 Gallop
     };
 
-    LED()
-        : lastTime_{0}, signalStyle_{Signal::Off}
+    // Higher priorities override lower ones
+    enum class Priority : uint8_t
     {
-        pinMode(LED_PIN, OUTPUT);
-        digitalWrite(LED_PIN, LOW);
-    }
+        Status = 0,   // machine state, always set
+        Notification, // short lived feedback
+        Error         // machine error, shown until cleared
+    };
 
-    // Update in loop to blink the led in the desired way
-    void Update(const unsigned long &CurrentTime) noexcept
-    {
-        const auto blinkIntervalProgress = CurrentTime % BLINK_INTERVAL;
-        const auto currentIndex = blinkIntervalProgress / (BLINK_INTERVAL / 8);
-        const auto ledState = 0x80 >> currentIndex & static_cast<uint8_t>(signalStyle_);
-        digitalWrite(LED_PIN, ledState);
-        lastTime_ = CurrentTime;
-        LOG_LED(String("blinkStyle: ") + static_cast<int>(signalStyle_) + " :: currentIndex = blinkIntervalProgress / BLINK_INTERVAL :: " + currentIndex + " = " + blinkIntervalProgress + " / " + BLINK_INTERVAL + " - LED: " + ledState)
-    }
+    LED();
+
+    // Sets a status type to be displayed by the led, eight steps within BLINK_INTERVAL
+    void ShowStatus(Signal SignalStyle) noexcept { Show(Priority::Status, SignalStyle); }
 
-    // Sets a status type to be displayed by the led
-    void ShowStatus(Signal SignalStyle)
+    // Shows a Signal with the given priority, eight steps within BLINK_INTERVAL
+    void Show(Priority Priority, Signal SignalStyle) noexcept
     {
-        signalStyle_ = SignalStyle;
-        LOG_LED(String("ShowStatus: ") + static_cast<int>(signalStyle_))
+        Show(Priority, static_cast<uint8_t>(SignalStyle), 8, BLINK_INTERVAL);
     }
 
+    // Shows the lowest Length bits of Bits (up to 32), most significant first, repeated every Period milliseconds
+    void Show(Priority Priority, uint32_t Bits, uint8_t Length, unsigned int Period) noexcept;
+
+    // Fades the led in and out once per Period milliseconds
+    void Breathe(Priority Priority, unsigned int Period = BREATHE_INTERVAL) noexcept;
+
+    // Removes the pattern of a priority, lower priorities show again
+    void Clear(Priority Priority) noexcept;
+
+    // Advances the pattern by one tick, called from the Ticker interrupt
+    static void Tick() noexcept;
+
 private:
-    Signal signalStyle_;
-    unsigned long lastTime_;
+    // Brightness levels of the software pwm used for breathing, one pwm period takes this many ticks
+    static constexpr const uint8_t PWM_LEVELS = 10;
+
+    struct Layer
+    {
+        uint32_t bits;          // pattern, lowest length bits are played msb first
+        uint8_t length;         // number of steps, 0 if the layer has no pattern
+        bool breathing;         // fade instead of on/off steps
+        unsigned int stepTicks; // ticks each step lasts at least
+        uint8_t extraTicks;     // ticks left over from Period / length, spread over the steps to keep Period exact
+    };
+
+    // Sets the layer of a priority and restarts playback if the shown pattern changed
+    void SetLayer(Priority Priority, const Layer& NewLayer) noexcept;
+
+    // Starts playing the active layer from its first step, call with interrupts disabled
+    void Restart() noexcept;
+
+    // Advances to the next step of the active layer
+    void Step() noexcept;
+
+    // Sets duration and brightness of the current step
+    void StartStep() noexcept;
+
+    static LED* instance_;
+
+    Layer layers_[3];
+
+    // Playback state of the active layer, owned by the interrupt once started
+    volatile uint8_t active_;
+    uint8_t step_;
+    uint32_t mask_;
+    unsigned int ticksLeft_;
+    uint8_t extraTicksAccumulator_;
+    uint8_t pwmCounter_;
+    uint8_t brightness_;
+    bool ledOn_;
 };
 
 #endif
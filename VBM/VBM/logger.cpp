@@ -0,0 +1,53 @@
+#include "logger.hpp"
+
+#include "txQueue.hpp"
+
+namespace
+{
+// Hex text of the record being built, one record at a time
+char record[TX_LINE_LENGTH];
+uint8_t recordLength = 0;
+
+void PutByte(uint8_t Byte)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    record[recordLength++] = HEX_DIGITS[Byte >> 4];
+    record[recordLength++] = HEX_DIGITS[Byte & 0x0F];
+}
+}  // namespace
+
+void Logger::Begin(PGM_P Format) noexcept
+{
+    // Flash addresses of the ATmega328P fit into 16 bit
+    const auto id = static_cast<uint16_t>(reinterpret_cast<uintptr_t>(Format));
+    recordLength = 0;
+    record[recordLength++] = '~';
+    PutByte(id & 0xFF);
+    PutByte(id >> 8);
+}
+
+void Logger::Put(uint8_t Tag, const void* Value, uint8_t Size) noexcept
+{
+    if (recordLength + 2 * (Size + 1) > TX_LINE_LENGTH)
+        return;
+    PutByte(Tag);
+    const auto bytes = static_cast<const uint8_t*>(Value);
+    for (uint8_t i = 0; i < Size; ++i)
+        PutByte(bytes[i]);
+}
+
+void Logger::Append(const char* Value) noexcept
+{
+    // Cut strings to what is left of the record, the length byte tells the decoder how much was sent
+    const int room = (TX_LINE_LENGTH - recordLength) / 2 - 2;
+    if (room < 0)
+        return;
+    const size_t length = strlen(Value);
+    const uint8_t size = length < static_cast<size_t>(room) ? length : room;
+    PutByte(0x30);
+    PutByte(size);
+    for (uint8_t i = 0; i < size; ++i)
+        PutByte(Value[i]);
+}
+
+void Logger::End() noexcept { TxQueue::Push(record, recordLength); }
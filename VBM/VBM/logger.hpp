@@ -0,0 +1,90 @@
+#ifndef __LOGGER_HPP
+#define __LOGGER_HPP
+
+#include <Arduino.h>
+
+// Tokenized debug log. The format string stays in flash and only its flash address is sent as id, followed by the
+// raw bytes of the arguments, so logging costs a few microseconds and no heap instead of building Strings.
+// Each record is a line on the serial port:
+//   ~<id lo><id hi>{<tag><value bytes>}   all bytes as two hex digits
+// The tag's high nibble is the kind (0 signed, 1 unsigned, 2 float, 3 string with a length byte) and the low
+// nibble the size of the value. Arguments replace the {} of the format string, tools/logdecode.py turns the
+// records back into text with the flash image of the firmware.
+// Records go through the TxQueue and are dropped if it overflows. Only log from the main loop.
+// Use the LOG_* macros of settings.hpp, e.g. LOG_CLOCK("Turn on at: {} <= {}", nextEventAt_, rtcUnixTime_)
+class Logger final
+{
+  public:
+    // Writes a record for the format string in flash and the given arguments
+    template <class... Arguments>
+    static void Log(PGM_P Format, Arguments... Values) noexcept
+    {
+        Begin(Format);
+        Add(Values...);
+        End();
+    }
+
+  private:
+    static void Add() noexcept {}
+
+    template <class First, class... Rest>
+    static void Add(First Value, Rest... Values) noexcept
+    {
+        Append(Value);
+        Add(Values...);
+    }
+
+    static void Append(bool Value) noexcept { Put(0x11, &Value, 1); }
+    static void Append(char Value) noexcept { Put(0x01, &Value, 1); }
+    static void Append(signed char Value) noexcept { Put(0x01, &Value, 1); }
+    static void Append(unsigned char Value) noexcept { Put(0x11, &Value, 1); }
+    static void Append(int Value) noexcept { AppendSigned(Value); }
+    static void Append(unsigned int Value) noexcept { AppendUnsigned(Value); }
+    static void Append(long Value) noexcept { AppendSigned(Value); }
+    static void Append(unsigned long Value) noexcept { AppendUnsigned(Value); }
+    static void Append(float Value) noexcept { Put(0x24, &Value, 4); }
+    static void Append(double Value) noexcept { Append(static_cast<float>(Value)); }
+    static void Append(const char* Value) noexcept;
+
+    // 16 bit on the Nano, 32 bit on host; larger values are truncated to 32 bit
+    template <class T>
+    static void AppendSigned(T Value) noexcept
+    {
+        if (sizeof(T) <= 2)
+        {
+            const int16_t value = Value;
+            Put(0x02, &value, 2);
+        }
+        else
+        {
+            const int32_t value = Value;
+            Put(0x04, &value, 4);
+        }
+    }
+
+    template <class T>
+    static void AppendUnsigned(T Value) noexcept
+    {
+        if (sizeof(T) <= 2)
+        {
+            const uint16_t value = Value;
+            Put(0x12, &value, 2);
+        }
+        else
+        {
+            const uint32_t value = Value;
+            Put(0x14, &value, 4);
+        }
+    }
+
+    // Starts a new record with the id of the format string
+    static void Begin(PGM_P Format) noexcept;
+
+    // Adds the tag and the little endian bytes of a value, values that do not fit into the record are left out
+    static void Put(uint8_t Tag, const void* Value, uint8_t Size) noexcept;
+
+    // Queues the record
+    static void End() noexcept;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "memoryMonitor.hpp"
+
+#ifdef __AVR__
+
+#include <stdlib.h>
+
+// Symbols provided by the linker script and avr-libc's malloc
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char* __brkval;
+
+struct __freelist
+{
+    size_t sz;
+    struct __freelist* nx;
+};
+extern struct __freelist* __flp;
+
+// Paint everything from the end of .bss up to the top of the stack. Runs in .init1 before the stack is used and
+// before r1 is cleared, so it must not rely on compiler generated code.
+void PaintFreeMemory() __attribute__((naked, used, section(".init1")));
+void PaintFreeMemory()
+{
+    __asm volatile(
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, %0\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n" ::"M"(MemoryMonitor::CANARY));
+}
+
+namespace
+{
+const uint8_t* HeapEnd() noexcept
+{
+    return __brkval ? reinterpret_cast<const uint8_t*>(__brkval) : &__heap_start;
+}
+
+const uint8_t* StackPointer() noexcept { return reinterpret_cast<const uint8_t*>(SP); }
+
+// Consecutive canary bytes that mark the end of the used stack, a single one can be regular data
+constexpr const uint8_t CANARY_RUN = 4;
+}  // namespace
+
+unsigned int MemoryMonitor::FreeHeap() noexcept
+{
+    unsigned int free = StackPointer() - HeapEnd();
+    for (auto block = __flp; block; block = block->nx)
+        free += block->sz + sizeof(size_t);
+    return free;
+}
+
+unsigned int MemoryMonitor::LargestFreeBlock() noexcept
+{
+    // malloc keeps __malloc_margin bytes to the stack when growing the heap
+    const unsigned int gap = StackPointer() - HeapEnd();
+    unsigned int largest = gap > __malloc_margin ? gap - __malloc_margin : 0;
+    for (auto block = __flp; block; block = block->nx)
+        if (block->sz > largest)
+            largest = block->sz;
+    return largest;
+}
+
+unsigned int MemoryMonitor::StackHighWaterMark() noexcept
+{
+    // Walk down from the current stack pointer until the untouched canary shows up; everything above was used by the
+    // stack at some point
+    const uint8_t* deepest = StackPointer();
+    uint8_t run = 0;
+    for (const uint8_t* address = deepest; address > HeapEnd(); --address)
+    {
+        if (*address != CANARY)
+        {
+            run = 0;
+            deepest = address;
+        }
+        else if (++run == CANARY_RUN)
+            break;
+    }
+    return &__stack - deepest + 1;
+}
+
+#if COUNT_STRING_ALLOCATIONS
+namespace
+{
+volatile unsigned long stringAllocations = 0;
+}  // namespace
+
+// WString is the only user of realloc in the core, -Wl,--wrap=realloc routes all calls through here
+extern "C" void* __real_realloc(void* Pointer, size_t Size);
+extern "C" void* __wrap_realloc(void* Pointer, size_t Size)
+{
+    ++stringAllocations;
+    return __real_realloc(Pointer, Size);
+}
+
+long MemoryMonitor::StringAllocations() noexcept { return stringAllocations; }
+#else
+long MemoryMonitor::StringAllocations() noexcept { return -1; }
+#endif
+
+#else
+
+// Host build: there is no shared heap/stack region to inspect, only the String allocations are known
+namespace Host
+{
+extern unsigned long stringAllocations;
+}  // namespace Host
+
+unsigned int MemoryMonitor::FreeHeap() noexcept { return 0; }
+
+unsigned int MemoryMonitor::LargestFreeBlock() noexcept { return 0; }
+
+unsigned int MemoryMonitor::StackHighWaterMark() noexcept { return 0; }
+
+long MemoryMonitor::StringAllocations() noexcept { return Host::stringAllocations; }
+
+#endif
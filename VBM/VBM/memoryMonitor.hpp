@@ -0,0 +1,27 @@
+#ifndef __MEMORY_MONITOR_HPP
+#define __MEMORY_MONITOR_HPP
+
+#include "settings.hpp"
+
+// SRAM usage of the running firmware. The free SRAM between heap and stack is painted with CANARY at boot, before
+// any constructor runs, so the deepest stack position ever reached can be found later by scanning for the pattern.
+class MemoryMonitor final
+{
+  public:
+    // Pattern written into free SRAM at boot
+    static constexpr const uint8_t CANARY = 0xC5;
+
+    // Bytes currently free between heap end and stack plus all blocks on the malloc free list
+    static unsigned int FreeHeap() noexcept;
+
+    // Largest block malloc could currently hand out in one piece
+    static unsigned int LargestFreeBlock() noexcept;
+
+    // Most stack in bytes used since boot
+    static unsigned int StackHighWaterMark() noexcept;
+
+    // Number of String allocations since boot, -1 if not counted (see COUNT_STRING_ALLOCATIONS)
+    static long StringAllocations() noexcept;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef __PINS_HPP
+#define __PINS_HPP
+
+#include "settings.hpp"
+
+// Pins as types, resolved at compile time. On the ATmega328P (Nano) every read or write compiles to a single
+// sbis/sbi/cbi on the port register instead of digitalRead/digitalWrite, which look the port up in flash tables and
+// check for pwm on every call (~50 cycles). sbi/cbi are atomic, so pins sharing a port with pins written from an
+// interrupt are safe. Other targets fall back to the Arduino functions.
+//
+// Arduino pin numbers on the ATmega328P: 0-7 PORTD, 8-13 PORTB, A0-A5 (14-19) PORTC.
+template <uint8_t Pin>
+struct PinRegisters final
+{
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+    static_assert(Pin < 20, "pin is not a digital pin of the ATmega328P");
+
+    static constexpr const uint8_t MASK = 1 << (Pin < 8 ? Pin : (Pin < 14 ? Pin - 8 : Pin - 14));
+
+    static volatile uint8_t& Port() { return Pin < 8 ? PORTD : (Pin < 14 ? PORTB : PORTC); }
+    static volatile uint8_t& Input() { return Pin < 8 ? PIND : (Pin < 14 ? PINB : PINC); }
+    static volatile uint8_t& Direction() { return Pin < 8 ? DDRD : (Pin < 14 ? DDRB : DDRC); }
+#endif
+};
+
+template <uint8_t Pin>
+class OutputPin final
+{
+  public:
+    static constexpr const uint8_t NUMBER = Pin;
+
+    // Configures the pin as output and drives it low
+    static void Init() noexcept
+    {
+        Low();
+        pinMode(Pin, OUTPUT);
+    }
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+    static void High() noexcept { PinRegisters<Pin>::Port() |= PinRegisters<Pin>::MASK; }
+    static void Low() noexcept { PinRegisters<Pin>::Port() &= ~PinRegisters<Pin>::MASK; }
+    static bool IsHigh() noexcept { return PinRegisters<Pin>::Port() & PinRegisters<Pin>::MASK; }
+#else
+    static void High() noexcept { digitalWrite(Pin, HIGH); }
+    static void Low() noexcept { digitalWrite(Pin, LOW); }
+    static bool IsHigh() noexcept { return digitalRead(Pin); }
+#endif
+
+    static void Write(bool Value) noexcept
+    {
+        if (Value)
+            High();
+        else
+            Low();
+    }
+};
+
+template <uint8_t Pin>
+class InputPin final
+{
+  public:
+    static constexpr const uint8_t NUMBER = Pin;
+
+    // Configures the pin as input, with pull up resistor by default
+    static void Init(bool Pullup = true) noexcept { pinMode(Pin, Pullup ? INPUT_PULLUP : INPUT); }
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+    static bool Read() noexcept { return PinRegisters<Pin>::Input() & PinRegisters<Pin>::MASK; }
+#else
+    static bool Read() noexcept { return digitalRead(Pin); }
+#endif
+
+    // Whether a switch between pin and GND is closed, for inputs with pull up
+    static bool IsClosed() noexcept { return !Read(); }
+};
+
+// The pins of this machine, see I/O pin settings in settings.hpp
+using BoilerSsrPin = OutputPin<BOILER_SSR_PIN>;
+using PumpSsrPin = OutputPin<PUMP_SSR_PIN>;
+using BrewButtonPin = InputPin<BUTTON_PIN_BREW>;
+using SwitchButtonPin = InputPin<BUTTON_PIN_SWITCH>;
+using LedPin = OutputPin<LED_PIN>;
+using ZeroCrossPin = InputPin<ZERO_CROSS_PIN>;
+using FlowMeterPin = InputPin<FLOW_METER_PIN>;
+
+#endif
@@ -0,0 +1,70 @@
+#include "pressureSensor.hpp"
+
+static_assert(PRESSURE_OVERSAMPLING_BITS <= 3, "the oversampling sum must fit 16 bits");
+
+volatile uint16_t PressureSensor::sum_ = 0;
+volatile uint8_t PressureSensor::count_ = 0;
+volatile uint32_t PressureSensor::results_ = 0;
+volatile uint16_t PressureSensor::numberOfResults_ = 0;
+double PressureSensor::ratio_ = -1;
+double PressureSensor::pressure_ = 0;
+unsigned long PressureSensor::updatedAt_ = 0;
+
+#ifdef __AVR__
+static_assert(PRESSURE_SENSOR_PIN >= A0 && PRESSURE_SENSOR_PIN <= A5, "the pressure sensor needs an analog pin");
+
+ISR(ADC_vect) { PressureSensor::Sample(ADC); }
+#endif
+
+void PressureSensor::Begin() noexcept
+{
+#ifdef __AVR__
+    const uint8_t channel = PRESSURE_SENSOR_PIN - A0;
+    // The digital input buffer only draws current on an analog level
+    DIDR0 |= _BV(channel);
+    // AVcc reference, the transducer is ratiometric to the same 5 V
+    ADMUX = _BV(REFS0) | channel;
+    // Free running: auto trigger from its own interrupt flag
+    ADCSRB = 0;
+    // Enable, start, auto trigger, interrupt, clk/128 --> 125 kHz at 16 MHz, 13 clocks per conversion
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+#endif
+}
+
+void PressureSensor::Update(unsigned long Now) noexcept
+{
+    noInterrupts();
+    const uint32_t results = results_;
+    const uint16_t numberOfResults = numberOfResults_;
+    results_ = 0;
+    numberOfResults_ = 0;
+    interrupts();
+    if (!numberOfResults)
+        return;
+
+    const double ratio = results / FULL_SCALE / numberOfResults;
+    if (ratio_ < 0)
+        ratio_ = ratio;
+    else
+    {
+        // First order low pass, independent of how often the loop comes by
+        const double dt = Now - updatedAt_;
+        ratio_ += (ratio - ratio_) * dt / (PRESSURE_FILTER_TIME + dt);
+    }
+    updatedAt_ = Now;
+
+    const double pressure = (ratio_ - PRESSURE_SENSOR_ZERO) / PRESSURE_SENSOR_SPAN * PRESSURE_SENSOR_MAX;
+    pressure_ = IsPresent() && pressure > 0 ? pressure : 0;
+}
+
+void PressureSensor::Sample(uint16_t Value) noexcept
+{
+    sum_ += Value;
+    if (++count_ < OVERSAMPLING)
+        return;
+    // Decimation: the sum of 4^n conversions has 2n more bits, n of them carry information
+    results_ += sum_ >> PRESSURE_OVERSAMPLING_BITS;
+    ++numberOfResults_;
+    sum_ = 0;
+    count_ = 0;
+}
@@ -0,0 +1,43 @@
+#ifndef __PRESSURE_SENSOR_HPP
+#define __PRESSURE_SENSOR_HPP
+
+#include "settings.hpp"
+
+// Reads a ratiometric pressure transducer (0.5-4.5 V from 5 V) on PRESSURE_SENSOR_PIN without costing loop time.
+// The ADC runs free on its own at 125 kHz, about 9600 conversions per second, and its interrupt sums them up:
+// every 4^PRESSURE_OVERSAMPLING_BITS conversions are decimated to one result with PRESSURE_OVERSAMPLING_BITS more
+// bits, the noise of the pump dithering the least significant bit. Update in the loop averages the results since its
+// last call and low passes them with PRESSURE_FILTER_TIME. analogRead would block for about 100 us per call instead.
+class PressureSensor final
+{
+  public:
+    static constexpr const uint8_t OVERSAMPLING = 1 << (2 * PRESSURE_OVERSAMPLING_BITS);
+    static constexpr const double FULL_SCALE = 1024UL << PRESSURE_OVERSAMPLING_BITS;
+
+    // Starts the free running conversions
+    static void Begin() noexcept;
+
+    // Filters the results since the last call, call in the loop
+    static void Update(unsigned long Now) noexcept;
+
+    // Filtered pressure in bar, 0 without a sensor
+    static double Pressure() noexcept { return pressure_; }
+
+    // Whether a sensor is connected: it never goes below its zero offset, a missing one is pulled to 0 V
+    static bool IsPresent() noexcept { return ratio_ >= PRESSURE_SENSOR_ZERO / 2; }
+
+    // Adds a conversion, called by the ADC interrupt
+    static void Sample(uint16_t Value) noexcept;
+
+  private:
+    static volatile uint16_t sum_;      // conversions of the running oversampling
+    static volatile uint8_t count_;
+    static volatile uint32_t results_;  // decimated results since the last Update
+    static volatile uint16_t numberOfResults_;
+
+    static double ratio_;  // filtered reading as fraction of the supply, negative before the first one
+    static double pressure_;
+    static unsigned long updatedAt_;
+};
+
+#endif
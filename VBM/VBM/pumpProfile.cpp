@@ -0,0 +1,96 @@
+#include "pumpProfile.hpp"
+
+#include "ticker.hpp"
+
+PumpProfile::Segment PumpProfile::segments_[PUMP_PROFILE_SEGMENTS] = {};
+uint8_t PumpProfile::segment_ = 0;
+uint8_t PumpProfile::scale_ = 255;
+unsigned long PumpProfile::segmentStartedAt_ = 0;
+volatile bool PumpProfile::running_ = false;
+volatile uint8_t PumpProfile::level_ = 0;
+uint16_t PumpProfile::accumulator_ = 0;
+uint8_t PumpProfile::ticks_ = 0;
+
+void PumpProfile::Begin() noexcept
+{
+    static bool attached = false;
+    if (!attached)
+        attached = Ticker::Attach(&PumpProfile::Tick);
+}
+
+void PumpProfile::SetSegment(uint8_t Index, const Segment& Segment) noexcept
+{
+    if (Index < PUMP_PROFILE_SEGMENTS)
+        segments_[Index] = Segment;
+}
+
+void PumpProfile::Start(unsigned long Now) noexcept
+{
+    segment_ = 0;
+    segmentStartedAt_ = Now;
+    Apply();
+    noInterrupts();
+    // Start with a pulse unless the profile starts with a pause, a pre-infusion should wet the puck right away
+    accumulator_ = level_ ? 255 - level_ : 0;
+    ticks_ = CYCLE_TICKS;
+    running_ = true;
+    interrupts();
+    LOG_VBM("Pump profile started")
+}
+
+void PumpProfile::Stop() noexcept
+{
+    running_ = false;
+    PumpSsrPin::Low();
+}
+
+void PumpProfile::Update(unsigned long Now) noexcept
+{
+    if (!running_ || segment_ == PUMP_PROFILE_SEGMENTS)
+        return;
+    const auto& segment = segments_[segment_];
+    if (segment.time && Now - segmentStartedAt_ >= segment.time * 100UL)
+    {
+        ++segment_;
+        segmentStartedAt_ = Now;
+        Apply();
+        LOG_VBM("Pump profile segment {}", segment_)
+    }
+}
+
+void PumpProfile::LimitPressure(double Pressure) noexcept
+{
+    const double headroom = PUMP_PRESSURE_LIMIT - Pressure;
+    uint8_t scale = 255;
+    if (PUMP_PRESSURE_LIMIT > 0 && headroom < PUMP_PRESSURE_BAND)
+        scale = headroom > 0 ? static_cast<uint8_t>(headroom / PUMP_PRESSURE_BAND * 255) : 0;
+    if (scale != scale_)
+    {
+        scale_ = scale;
+        Apply();
+    }
+}
+
+void PumpProfile::Apply() noexcept
+{
+    // Everything from an end segment on runs at full power
+    if (segment_ < PUMP_PROFILE_SEGMENTS && IsEnd(segments_[segment_]))
+        segment_ = PUMP_PROFILE_SEGMENTS;
+    const uint8_t duty = segment_ < PUMP_PROFILE_SEGMENTS ? segments_[segment_].duty : 100;
+    level_ = static_cast<uint8_t>(duty * 255UL * scale_ / (100UL * 255U));
+}
+
+void PumpProfile::Tick() noexcept
+{
+    if (!running_ || ++ticks_ < CYCLE_TICKS)
+        return;
+    ticks_ = 0;
+    accumulator_ += level_;
+    if (accumulator_ >= 255)
+    {
+        accumulator_ -= 255;
+        PumpSsrPin::High();
+    }
+    else
+        PumpSsrPin::Low();
+}
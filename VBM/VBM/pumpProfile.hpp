@@ -0,0 +1,72 @@
+#ifndef __PUMP_PROFILE_HPP
+#define __PUMP_PROFILE_HPP
+
+#include "pins.hpp"
+#include "settings.hpp"
+
+// Runs the pump through a sequence of timed segments while the lever is down, e.g. pre-infusion at 30 % for 4 s,
+// a pause of 3 s, then full power. The duty of a segment is put on the SSR by burst control from the Ticker: a
+// first order sigma-delta modulator decides for every mains cycle whether the pump runs, so 30 % is every third
+// cycle. Whole cycles, since a vibratory pump only takes one half-cycle through its diode. The segments are
+// sequenced by Update in the main loop. After the last segment, or without any, the pump runs at full power.
+// With PUMP_PRESSURE_LIMIT and a pressure sensor, the duty is scaled down over the last PUMP_PRESSURE_BAND below the
+// limit, so the pressure settles there instead of at the overpressure valve.
+class PumpProfile final
+{
+  public:
+    static constexpr const uint8_t CYCLE_TICKS = TICK_FREQUENCY / MAINS_FREQUENCY;
+
+    struct Segment
+    {
+        uint8_t duty;  // percent
+        uint8_t time;  // 1/10 s, 0 holds the segment until the lever goes up
+    };
+
+    // Whether a segment ends the profile: all zero, or erased eeprom
+    static bool IsEnd(const Segment& Segment) noexcept
+    {
+        return Segment.duty > 100 || (Segment.duty == 0 && Segment.time == 0);
+    }
+
+    // Attaches the tick handler, safe to call more than once
+    static void Begin() noexcept;
+
+    // Sets a segment of the profile run from the next Start
+    static void SetSegment(uint8_t Index, const Segment& Segment) noexcept;
+
+    // Runs the profile from its first segment
+    static void Start(unsigned long Now) noexcept;
+
+    // Turns the pump off
+    static void Stop() noexcept;
+
+    // Moves on to the next segment when the current one is over, call in the loop
+    static void Update(unsigned long Now) noexcept;
+
+    // Backs the duty off as Pressure in bar nears PUMP_PRESSURE_LIMIT, call with every new reading
+    static void LimitPressure(double Pressure) noexcept;
+
+    static bool IsRunning() noexcept { return running_; }
+
+    // Segment running, PUMP_PROFILE_SEGMENTS at full power after the last one
+    static uint8_t CurrentSegment() noexcept { return segment_; }
+
+    // Decides the SSR state for the next mains cycle, done by the Ticker
+    static void Tick() noexcept;
+
+  private:
+    // Takes the duty of the current segment over
+    static void Apply() noexcept;
+
+    static Segment segments_[PUMP_PROFILE_SEGMENTS];
+    static uint8_t segment_;
+    static uint8_t scale_;  // share of the segment's duty the pressure allows, in 1/255
+    static unsigned long segmentStartedAt_;
+
+    static volatile bool running_;
+    static volatile uint8_t level_;  // duty in 1/255
+    static uint16_t accumulator_;
+    static uint8_t ticks_;           // ticks since the last mains cycle
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "readiness.hpp"
+
+Readiness::Readiness() noexcept
+    : filtered_{0},
+      lastSampleAt_{0},
+      intervalStart_{0},
+      intervalStartAt_{0},
+      slope_{0},
+      hasSlope_{false},
+      stableSince_{0},
+      stable_{false},
+      ready_{false},
+      confidence_{0},
+      started_{false}
+{
+}
+
+void Readiness::Restart() noexcept
+{
+    stable_ = false;
+    ready_ = false;
+    confidence_ = 0;
+}
+
+void Readiness::Update(double Temperature, double Setpoint, unsigned long Now) noexcept
+{
+    if (!started_)
+    {
+        started_ = true;
+        filtered_ = Temperature;
+        intervalStart_ = Temperature;
+        intervalStartAt_ = Now;
+    }
+    else
+    {
+        // First order low pass, independent of how often samples come
+        const double dt = Now - lastSampleAt_;
+        filtered_ += (Temperature - filtered_) * dt / (READY_FILTER_TIME + dt);
+    }
+    lastSampleAt_ = Now;
+
+    if (Now - intervalStartAt_ >= READY_SLOPE_INTERVAL)
+    {
+        slope_ = (filtered_ - intervalStart_) * 1000.0 / (Now - intervalStartAt_);
+        hasSlope_ = true;
+        intervalStart_ = filtered_;
+        intervalStartAt_ = Now;
+    }
+
+    const bool inBand = Setpoint - IS_READY_RANGE < Temperature && Temperature < Setpoint + IS_READY_RANGE;
+    if (!inBand)
+    {
+        Restart();
+        return;
+    }
+
+    // The slope is also low at the turning points of an oscillation, so it has to stay low for the whole hold time
+    const double absoluteSlope = fabs(slope_);
+    const bool flat = hasSlope_ && absoluteSlope <= READY_MAX_SLOPE;
+    if (!flat)
+        stable_ = false;
+    else if (!stable_)
+    {
+        stable_ = true;
+        stableSince_ = Now;
+    }
+
+    const double stableFor = stable_ ? Now - stableSince_ : 0;
+    const double timeFactor = stableFor < READY_HOLD_TIME ? stableFor / READY_HOLD_TIME : 1.0;
+    double slopeFactor = 0;
+    if (hasSlope_)
+        slopeFactor = flat ? 1.0 : READY_MAX_SLOPE / absoluteSlope;
+    // Half for a flat slope, half for staying flat
+    confidence_ = static_cast<uint8_t>(50 * slopeFactor + 50 * timeFactor);
+    if (confidence_ == 100 && !ready_)
+    {
+        LOG_HEATER("Ready after {} ms stable in range, slope {}", static_cast<unsigned long>(stableFor), slope_)
+        ready_ = true;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef __READINESS_HPP
+#define __READINESS_HPP
+
+#include "settings.hpp"
+
+// Estimates whether the boiler settled at its setpoint. Entering the band of IS_READY_RANGE is not enough, on a fast
+// heat-up that happens in the middle of the overshoot: the temperature has to stay in the band and change slower
+// than READY_MAX_SLOPE for READY_HOLD_TIME. The slope is taken from the low pass filtered temperature over
+// READY_SLOPE_INTERVAL, which keeps the readout noise of single samples out of it.
+class Readiness final
+{
+  public:
+    Readiness() noexcept;
+
+    // Starts over for a new setpoint, the slope estimate is kept
+    void Restart() noexcept;
+
+    // Feeds a temperature sample taken at Now (millis())
+    void Update(double Temperature, double Setpoint, unsigned long Now) noexcept;
+
+    // Ready once the confidence reached 100, stays ready until the temperature leaves the band
+    bool IsReady() const noexcept { return ready_; }
+
+    // 0 to 100: half for how close the slope is to READY_MAX_SLOPE, half for how long it stayed there relative to
+    // READY_HOLD_TIME, 0 outside of the band
+    uint8_t Confidence() const noexcept { return confidence_; }
+
+    // Milliseconds the temperature still has to stay stable to be ready, READY_HOLD_TIME if it is not stable yet
+    unsigned long TimeToReady(unsigned long Now) const noexcept
+    {
+        if (ready_)
+            return 0;
+        const unsigned long stableFor = stable_ ? Now - stableSince_ : 0;
+        return stableFor < READY_HOLD_TIME ? READY_HOLD_TIME - stableFor : 0;
+    }
+
+    // Filtered temperature change in degrees per second, 0 until the first READY_SLOPE_INTERVAL passed
+    double Slope() const noexcept { return slope_; }
+
+  private:
+    double filtered_;  // low pass filtered temperature
+    unsigned long lastSampleAt_;
+    double intervalStart_;  // filtered temperature at the start of the slope interval
+    unsigned long intervalStartAt_;
+    double slope_;
+    bool hasSlope_;
+
+    unsigned long stableSince_;
+    bool stable_;  // in range and flat since stableSince_
+    bool ready_;
+    uint8_t confidence_;
+    bool started_;  // got the first sample
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "rtdChannel.hpp"
+
+#include <SPI.h>
+
+namespace
+{
+constexpr const uint8_t CONFIG_REGISTER = 0x00;
+constexpr const uint8_t RTD_REGISTER = 0x01;
+constexpr const uint8_t FAULT_REGISTER = 0x07;
+constexpr const uint8_t CONFIG_BIAS = 0x80;
+constexpr const uint8_t CONFIG_ONE_SHOT = 0x20;
+constexpr const uint8_t CONFIG_FAULT_CLEAR = 0x02;
+constexpr const uint8_t WRITE = 0x80;
+
+// Settings of the library: 1 MHz, clock idles low and data is taken on the falling edge
+const SPISettings MAX31865_SPI(1000000, MSBFIRST, SPI_MODE1);
+}  // namespace
+
+RtdChannel::RtdChannel(uint8_t ChipSelect, unsigned int Interval) noexcept
+    : max31865_(ChipSelect),
+      chipSelect_{ChipSelect},
+      interval_{Interval},
+      config_{0},
+      phase_{Phase::Bias},
+      stepAt_{0},
+      wait_{0},
+      temperature_{0},
+      fault_{0},
+      present_{false}
+{
+}
+
+bool RtdChannel::Begin() noexcept
+{
+    max31865_.begin(MAX31865_TYPE);
+    Transfer(CONFIG_REGISTER, &config_, 1, false);
+    config_ &= ~(CONFIG_BIAS | CONFIG_ONE_SHOT | CONFIG_FAULT_CLEAR);
+
+    // Once through all steps, waiting in between
+    phase_ = Phase::Bias;
+    while (!Step(millis()))
+        delay(wait_);
+    // A missing chip reads as 0 or all ones, far outside of any temperature of the machine
+    present_ = !fault_ && temperature_ >= SUPERVISOR_MIN_TEMP && temperature_ <= 2 * SUPERVISOR_MAX_TEMP;
+    return present_;
+}
+
+bool RtdChannel::Step(unsigned long Now) noexcept
+{
+    stepAt_ = Now;
+    switch (phase_)
+    {
+        case Phase::Bias:
+            WriteConfig(config_ | CONFIG_BIAS | CONFIG_FAULT_CLEAR);
+            phase_ = Phase::Convert;
+            wait_ = BIAS_TIME;
+            return false;
+        case Phase::Convert:
+            WriteConfig(config_ | CONFIG_BIAS | CONFIG_ONE_SHOT);
+            phase_ = Phase::Read;
+            wait_ = CONVERSION_TIME;
+            return false;
+        default:
+        case Phase::Read: {
+            // RTD, the thresholds in between and the fault status in one go
+            uint8_t registers[FAULT_REGISTER - RTD_REGISTER + 1] = {};
+            Transfer(RTD_REGISTER, registers, sizeof(registers), false);
+            // Bias off until the next reading against self heating
+            WriteConfig(config_);
+            const uint16_t rtd = (registers[0] << 8 | registers[1]) >> 1;
+            temperature_ = max31865_.calculateTemperature(rtd, RNOMINAL, RREF);
+            fault_ = registers[FAULT_REGISTER - RTD_REGISTER];
+            phase_ = Phase::Bias;
+            wait_ = interval_;
+            return true;
+        }
+    }
+}
+
+void RtdChannel::Transfer(uint8_t Address, uint8_t* Data, uint8_t Length, bool Write) noexcept
+{
+    SPI.beginTransaction(MAX31865_SPI);
+    digitalWrite(chipSelect_, LOW);
+    SPI.transfer(Write ? Address | WRITE : Address);
+    for (uint8_t i = 0; i < Length; ++i)
+        Data[i] = SPI.transfer(Write ? Data[i] : 0xFF);
+    digitalWrite(chipSelect_, HIGH);
+    SPI.endTransaction();
+}
+
+void RtdChannel::WriteConfig(uint8_t Config) noexcept { Transfer(CONFIG_REGISTER, &Config, 1, true); }
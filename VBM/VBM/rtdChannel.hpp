@@ -0,0 +1,61 @@
+#ifndef __RTD_CHANNEL_HPP
+#define __RTD_CHANNEL_HPP
+
+#include <Adafruit_MAX31865.h>
+
+#include "settings.hpp"
+
+// A MAX31865 read in steps. The library's temperature() blocks for 75 ms on every call: bias on, wait for the input
+// filter, start a one-shot conversion, wait for it. Here each of these is a Step of one short SPI transaction, the
+// waiting is left to the loop. Chips on the shared bus convert at the same time, the owner of the channels only
+// runs one step per loop, see Heater. The library still sets the chip up and converts the reading.
+class RtdChannel final
+{
+  public:
+    static constexpr const uint8_t BIAS_TIME = 10;        // ms for the input filter to settle after bias on
+    static constexpr const uint8_t CONVERSION_TIME = 65;  // ms of a one-shot conversion, at most 62.5 ms
+
+    // Interval: ms from one reading to the start of the next, 0 back to back
+    RtdChannel(uint8_t ChipSelect, unsigned int Interval) noexcept;
+
+    // Sets the chip up and takes a first reading, which blocks for one conversion. Returns whether the chip answers
+    // with a plausible temperature.
+    bool Begin() noexcept;
+
+    bool IsPresent() const noexcept { return present_; }
+
+    // Whether the next step is due
+    bool IsDue(unsigned long Now) const noexcept { return Now - stepAt_ >= wait_; }
+
+    // Runs the next step, returns true when it read a new temperature
+    bool Step(unsigned long Now) noexcept;
+
+    // Last reading and the fault register read with it
+    double Temperature() const noexcept { return temperature_; }
+    uint8_t Fault() const noexcept { return fault_; }
+
+  private:
+    enum class Phase : uint8_t
+    {
+        Bias,
+        Convert,
+        Read
+    };
+
+    // One SPI transaction from Address on, Write sets the write bit
+    void Transfer(uint8_t Address, uint8_t* Data, uint8_t Length, bool Write) noexcept;
+    void WriteConfig(uint8_t Config) noexcept;
+
+    Adafruit_MAX31865 max31865_;
+    uint8_t chipSelect_;
+    unsigned int interval_;
+    uint8_t config_;  // configuration set up by the library, bias and one-shot off
+    Phase phase_;
+    unsigned long stepAt_;
+    unsigned int wait_;
+    double temperature_;
+    uint8_t fault_;
+    bool present_;
+};
+
+#endif
@@ -2,3 +2,9 @@
 
 float SETPOINT_BREW_TEMP = 103.0;
 float SETPOINT_STEAM_TEMP = 140.0;
+float SETPOINT_ECO_TEMP = 80.0;
+float SETPOINT_GROUP_TEMP = 0;
+uint16_t SLEEP_TIMEOUT = 30;
+uint16_t HEATER_WATTAGE = 1200;
+uint16_t TARGET_VOLUME = 0;
+float PUMP_PRESSURE_LIMIT = 0;
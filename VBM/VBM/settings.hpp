@@ -3,12 +3,22 @@
 
 #include <Arduino.h>
 
+#include "logger.hpp"
+
 // Global useful parameters to set for building and testing
 #define DISABLE_HEATER 0  // default false; if true the heater will never actually turn on, all code paths run normally
 #define DISABLE_PUMP 0    // default false; if true the pump will never actually turn on, all code paths run normally
 // Load eeprom parameters as far as available with settings here as fallback
 // ATTENTION: On a new board, this must at least be true ONCE to initialize the EEPROM to valid values!
 #define LOAD_INITIAL_PARAMETERS_FROM_EEPROM 1  // Default true;
+// Count String (re)allocations for the mem command. Needs the linker to wrap realloc, add
+// "compiler.c.elf.extra_flags=-Wl,--wrap=realloc" to platform.local.txt of the avr core before enabling.
+#define COUNT_STRING_ALLOCATIONS 0  // Default false;
+// Heater output: 0 switches the SSR in the time proportional window of the PID (WINDOW_SIZE), 1 spreads the power
+// over single mains half-cycles, see SigmaDelta
+#define HEATER_OUTPUT_SIGMA_DELTA 0  // Default false;
+// Clock the sigma-delta half-cycles from a zero-cross detector on ZERO_CROSS_PIN instead of the ticker
+#define ZERO_CROSS 0  // Default false;
 
 // Turn on/off debug information for each module
 #define DEBUG_EEPROM_MEMORY 0
@@ -28,59 +38,66 @@
 #define INITIALIZE_EEPROM 0
 #endif
 
+// Sends a tokenized log record, the format string stays in flash, see logger.hpp
+#define LOG_RECORD(format, ...)                            \
+    do                                                     \
+    {                                                      \
+        static const char logFormat[] PROGMEM = format;    \
+        Logger::Log(logFormat, ##__VA_ARGS__);             \
+    } while (0);
+
 #if DEBUG_EEPROM_MEMORY == 0
-#define LOG_EEPROM_MEMORY(message)
+#define LOG_EEPROM_MEMORY(...)
 #else
-#define LOG_EEPROM_MEMORY(message) Serial.println(message);
+#define LOG_EEPROM_MEMORY(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_EEPROM_MEMORY_PRECISION == 0
-#define LOG_EEPROM_MEMORY_PRECISION(message)
+#define LOG_EEPROM_MEMORY_PRECISION(...)
 #else
-#define LOG_EEPROM_MEMORY_PRECISION(message) \
-    Serial.println(message, 7);  // 6 to 7 digits total supported on AVR (float)
+#define LOG_EEPROM_MEMORY_PRECISION(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_CLOCK == 0
-#define LOG_CLOCK(message)
+#define LOG_CLOCK(...)
 #else
-#define LOG_CLOCK(message) Serial.println(message);
+#define LOG_CLOCK(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_COMM == 0
-#define LOG_COMM(message)
+#define LOG_COMM(...)
 #else
-#define LOG_COMM(message) Serial.println(message);
+#define LOG_COMM(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_BUTTON_SWITCH == 0
-#define LOG_BUTTON_SWITCH(message)
+#define LOG_BUTTON_SWITCH(...)
 #else
-#define LOG_BUTTON_SWITCH(message) Serial.println(message);
+#define LOG_BUTTON_SWITCH(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_BUTTON_BREW == 0
-#define LOG_BUTTON_BREW(message)
+#define LOG_BUTTON_BREW(...)
 #else
-#define LOG_BUTTON_BREW(message) Serial.println(message);
+#define LOG_BUTTON_BREW(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_HEATER == 0
-#define LOG_HEATER(message)
+#define LOG_HEATER(...)
 #else
-#define LOG_HEATER(message) Serial.println(message);
+#define LOG_HEATER(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_LED == 0
-#define LOG_LED(message)
+#define LOG_LED(...)
 #else
-#define LOG_LED(message) Serial.println(message);
+#define LOG_LED(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #if DEBUG_VBM == 0
-#define LOG_VBM(message)
+#define LOG_VBM(...)
 #else
-#define LOG_VBM(message) Serial.println(message);
+#define LOG_VBM(...) LOG_RECORD(__VA_ARGS__)
 #endif
 
 #pragma endregion debug helper definitions
@@ -91,11 +108,15 @@
 // Adafruit_MAX31865 thermocouple_ = Adafruit_MAX31865(10, 11, 12, 13);
 // use hardware SPI, just pass in the CS pin
 constexpr const int BOILER_TEMP_CS_PIN = A0;  // CS/SS for hardware SPI
+constexpr const int GROUP_TEMP_CS_PIN = A3;   // optional second MAX31865 with an RTD on the group head
 constexpr const int BOILER_SSR_PIN = 3;
 constexpr const int PUMP_SSR_PIN = 9;
 constexpr const int BUTTON_PIN_BREW = 2;    // connects to PIN and GND, for brew lever switch
 constexpr const int BUTTON_PIN_SWITCH = 7;  // connects to PIN and GND, for manual switch
 constexpr const int LED_PIN = 8;
+constexpr const int ZERO_CROSS_PIN = A2;  // optional zero-cross detector output, see ZERO_CROSS
+constexpr const int FLOW_METER_PIN = 4;   // hall effect flow meter between pump and boiler, see FlowMeter
+constexpr const int PRESSURE_SENSOR_PIN = A1;  // pressure transducer, 100k to GND so a missing one reads 0 V
 
 #pragma endregion I / O pin settings
 
@@ -103,13 +124,17 @@ constexpr const int LED_PIN = 8;
 // Set fallback if it cannot be loaded from eeprom in settings.cpp
 extern float SETPOINT_BREW_TEMP;
 extern float SETPOINT_STEAM_TEMP;
+extern float SETPOINT_ECO_TEMP;     // setpoint while asleep, see SLEEP_TIMEOUT
+extern float SETPOINT_GROUP_TEMP;   // group temperature the brew setpoint is trimmed for, 0 none, see GroupCascade
+extern uint16_t SLEEP_TIMEOUT;      // minutes without input in IdleBrew until the machine sleeps, 0 never
+extern uint16_t HEATER_WATTAGE;     // rated heater power in W, see EnergyMeter
+extern uint16_t TARGET_VOLUME;      // ml after which the pump stops on its own, 0 never, see FlowMeter
+extern float PUMP_PRESSURE_LIMIT;   // bar the pump profile holds the pressure below, 0 none, see PumpProfile
 
 #pragma endregion eeprom loadable / saveable user fallback variables
 
 #pragma region user variables
 
-const constexpr float MAX_TEMP = 135.0;  // max allowed temp on PID computation
-
 // PID ******************************************************************************
 // best precision: +-0.5 degree: 0.1, 0, 800, oscillates by +-0.5degree
 const constexpr double KP = 0.08;
@@ -125,17 +150,91 @@ constexpr const double WINDOW_SIZE = 3000.0;
 // 100.0 for PT100, 1000.0 for PT1000
 #define RNOMINAL 1000.0
 
+// Group head ***********************************************************************
+const unsigned int GROUP_TEMP_INTERVAL = 1000;  // time in milliseconds between group temperature readings
+const constexpr double GROUP_KP = 1.0;          // degrees of boiler trim per degree the group is off
+const constexpr double GROUP_KI = 0.005;        // degrees of boiler trim per degree and second the group is off
+const constexpr double GROUP_CASCADE_RANGE = 10.0;  // degrees the boiler setpoint is trimmed by at most
+// Model of the group head estimate, see GroupObserver. Time constants in seconds.
+const unsigned int OBSERVER_INTERVAL = 250;          // time in milliseconds between steps of the estimate
+const constexpr double AMBIENT_TEMP = 20.0;           // degrees of the room and the fresh water
+const constexpr double GROUP_HEAT_TIME = 600.0;       // the group following the boiler through its mount
+const constexpr double GROUP_LOSS_TIME = 2400.0;      // the group cooling down to the room
+const constexpr double GROUP_FLUSH_TIME = 30.0;       // the group following the boiler water while the pump runs
+const constexpr double GROUP_CAPACITY_RATIO = 0.5;    // heat capacity of the group over the one of the boiler
+const constexpr double BOILER_LOSS_TIME = 3000.0;     // the boiler cooling down to the room
+const constexpr double BOILER_FLUSH_TIME = 90.0;      // the boiler refilled with fresh water while the pump runs
+const constexpr double OBSERVER_GAIN_BOILER = 0.05;   // share of a boiler reading's error the boiler estimate takes
+const constexpr double OBSERVER_GAIN_GROUP = 0.005;   // share of a boiler reading's error the group estimate takes
+
 #pragma endregion user variables
 
 #pragma region global program stuff
 
-const uint8_t IS_READY_RANGE = 4;          // +/- this range signals heater ready state
+const uint8_t IS_READY_RANGE = 4;          // +/- this range around the setpoint counts as settled, see Readiness
+const unsigned long READY_HOLD_TIME = 30000;  // time in milliseconds the temperature must stay in range to be ready
+const constexpr double READY_MAX_SLOPE = 0.02;  // fastest temperature change in degrees/s that counts as settled
+const unsigned int READY_SLOPE_INTERVAL = 5000;  // time in milliseconds the readiness slope is measured over
+const unsigned int READY_FILTER_TIME = 2000;     // time constant in milliseconds of the readiness low pass
+const constexpr double ETA_DEFAULT_HEATING_RATE = 0.4;   // degrees/s at full power until one is learned
+const constexpr double ETA_DEFAULT_COOLING_RATE = 0.05;  // degrees/s with the heater off until one is learned
+const unsigned long ETA_DEFAULT_SETTLE_TIME = 45000;    // time in milliseconds from reaching the range to ready
+const constexpr double ETA_MIN_LEARNING_DUTY = 0.5;      // SSR duty cycle from which the heating rate is learned
+const constexpr double ETA_LEARNING_RATE = 0.2;          // weight of a new observation of a rate
+const constexpr double STEAM_DRAW_SLOPE = 0.1;  // degrees/s the steam temperature must fall to detect a draw
+const unsigned int STEAM_DRAW_DETECT_TIME = 5000;  // time in milliseconds the fall must last to detect a draw
+const constexpr double STEAM_BOOST_OFFSET = 5.0;   // degrees the steam setpoint is raised by, up to MAX_SETPOINT
+const unsigned long STEAM_BOOST_MAX_TIME = 120000;  // time in milliseconds after which a boost ends in any case
 const unsigned int BLINK_INTERVAL = 2500;  // blink time in milliseconds, max 4 on/off in this time
+const unsigned int BREATHE_INTERVAL = 4000;  // time in milliseconds for the led to fade in and out once
+const unsigned int TICK_FREQUENCY = 1000;    // hardware timer interrupt frequency in Hz, 1 tick = 1 ms
+const uint8_t MAINS_FREQUENCY = 50;          // Hz, the sigma-delta heater output switches per half-cycle
 
 const uint8_t BUTTON_PRESS_SHORT = 2;  // time to register short button press in seconds
 const uint8_t BUTTON_PRESS_LONG = 5;   // time to register long button press in seconds
 const uint8_t DEBOUNCE_DELAY = 50;     // time to ignore button input in milliseconds
 
+const uint8_t NUMBER_OF_TIMERS = 2;                // weekday on/off timers, each takes 5 bytes of eeprom
+const uint8_t PUMP_PROFILES = 3;                   // pump profiles to choose from, see PumpProfile
+const uint8_t PUMP_PROFILE_SEGMENTS = 4;           // segments of a pump profile, each takes 2 bytes of eeprom
+const unsigned long CLOCK_SYNC_INTERVAL = 60000;  // time in milliseconds after which millis() is synced to the RTC
+const unsigned int CLOCK_HEAT_UP_RESOLUTION = 60;  // seconds the heat-up time must change to replan ready-by timers
+const unsigned int READY_BY_SOAK_TIME = 900;       // seconds a ready-by timer heats on top of the boiler for the group
+const unsigned long RTC_TIMEOUT = 25000;          // I2C timeout in microseconds, a missing RTC must not hang the boot
+const uint8_t STATE_LOG_SIZE = 8;                 // machine state transitions kept for the statelog command
+const uint8_t FLIGHT_RECORDER_SIZE = 16;          // entries of the flight recorder, each takes 6 bytes of RAM
+const unsigned int FLIGHT_RECORDER_EEPROM = 896;  // start of the eeprom region reserved for the flight recorder
+const unsigned long FLIGHT_RECORDER_TEMPERATURE_INTERVAL = 10000;  // time in milliseconds between recorded temps
+const unsigned int STATS_EEPROM = 768;             // start of the eeprom region of the energy meter, 2 slots
+const uint8_t STATS_DAYS = 7;                      // days the daily energy is kept for
+const unsigned long STATS_SAVE_INTERVAL = 3600000;  // time in milliseconds between saves of the energy meter
+const unsigned int STATS_MIN_SHOT_TIME = 10000;     // time in milliseconds the lever must be down to count a shot
+const constexpr double FLOW_METER_PULSES_PER_ML = 1.925;  // pulses of the flow meter per ml, Digmesa FHKSC
+const unsigned int FLOW_INTERVAL = 250;         // time in milliseconds between flow measurements
+const unsigned int FLOW_TIMEOUT = 2000;         // time in milliseconds without a pulse after which the flow is 0
+const unsigned int FLOW_REPORT_INTERVAL = 500;  // time in milliseconds between >volume: and >flow: while brewing
+const uint8_t PRESSURE_OVERSAMPLING_BITS = 2;            // extra ADC bits by oversampling 4^n times, at most 3
+const unsigned int PRESSURE_FILTER_TIME = 200;           // time constant in milliseconds of the pressure low pass
+const constexpr double PRESSURE_SENSOR_ZERO = 0.1;       // output at 0 bar as fraction of the supply, 0.5 V of 5 V
+const constexpr double PRESSURE_SENSOR_SPAN = 0.8;       // output from 0 bar to full scale, 4.5 V - 0.5 V of 5 V
+const constexpr double PRESSURE_SENSOR_MAX = 12.0;       // bar at full scale of the sensor
+const constexpr double PUMP_PRESSURE_BAND = 1.0;         // bar below PUMP_PRESSURE_LIMIT the pump starts backing off
+
+const constexpr double SUPERVISOR_MIN_TEMP = -20.0;  // a colder reading means the RTD is missing or shorted
+const constexpr double SUPERVISOR_MAX_TEMP = 160.0;  // a hotter reading trips, see MAX_SETPOINT for the margin
+const constexpr double MAX_SETPOINT = SUPERVISOR_MAX_TEMP - 10.0;  // highest setpoint, the steam boost's included
+const constexpr double SUPERVISOR_MAX_SLOPE = 5.0;  // fastest plausible boiler temperature change in degrees/s
+const unsigned int SUPERVISOR_SAMPLE_TIMEOUT = 1000;  // time in milliseconds without a temperature sample to trip
+#define WATCHDOG_TIMEOUT WDTO_1S  // resets the board if the main loop hangs, see Supervisor
+
+const unsigned int TX_QUEUE_SIZE = 224;  // bytes of the outbound serial queue, an updateapp streams through it
+const uint8_t TX_LINE_LENGTH = 48;       // longest line sent without line end, must fit the 64 byte UART buffer
+const uint8_t TX_BYTES_PER_LOOP = 32;    // bytes handed to the UART per loop, at least one line is always sent
+const uint8_t TEMPERATURE_REPORT_RESOLUTION = 10;  // 1/100 degrees the temperature must change to be sent again
+const uint8_t READINESS_REPORT_RESOLUTION = 4;     // percent the readiness confidence must change to be sent again
+const uint8_t ETA_REPORT_RESOLUTION = 5;           // seconds the ready eta must change to be sent again
+const uint8_t PRESSURE_REPORT_RESOLUTION = 10;     // 1/100 bar the pressure must change to be sent again
+
 #pragma endregion global program stuff
 
 #endif
@@ -0,0 +1,71 @@
+#include "sigmaDelta.hpp"
+
+#include "supervisor.hpp"
+#include "ticker.hpp"
+
+volatile uint8_t SigmaDelta::level_ = 0;
+uint16_t SigmaDelta::accumulator_ = 0;
+uint8_t SigmaDelta::ticks_ = 0;
+
+#if ZERO_CROSS && defined(__AVR__)
+static_assert(ZERO_CROSS_PIN >= A0 && ZERO_CROSS_PIN <= A5, "the zero-cross interrupt expects a pin of PORTC");
+
+// A detector pulses around every zero crossing, only its rising edge counts
+ISR(PCINT1_vect)
+{
+    if (ZeroCrossPin::Read())
+        SigmaDelta::HalfCycle();
+}
+#endif
+
+void SigmaDelta::Begin() noexcept
+{
+    Ticker::Attach(&SigmaDelta::Tick);
+#if ZERO_CROSS
+    ZeroCrossPin::Init(false);
+#ifdef __AVR__
+    *digitalPinToPCMSK(ZERO_CROSS_PIN) |= _BV(digitalPinToPCMSKbit(ZERO_CROSS_PIN));
+    PCICR |= _BV(digitalPinToPCICRbit(ZERO_CROSS_PIN));
+#endif
+#endif
+}
+
+void SigmaDelta::SetPower(double Power) noexcept
+{
+    if (Power <= 0)
+        level_ = 0;
+    else if (Power >= 1)
+        level_ = 255;
+    else
+        level_ = static_cast<uint8_t>(Power * 255 + 0.5);
+}
+
+void SigmaDelta::HalfCycle() noexcept
+{
+    ticks_ = 0;
+    // The supervisor holds the SSR low on its own tick, do not switch it on in between
+    if (Supervisor::Tripped() != Supervisor::Fault::None)
+    {
+        accumulator_ = 0;
+        BoilerSsrPin::Low();
+        return;
+    }
+
+    accumulator_ += level_;
+    if (accumulator_ >= 255)
+    {
+        accumulator_ -= 255;
+        BoilerSsrPin::High();
+    }
+    else
+        BoilerSsrPin::Low();
+}
+
+void SigmaDelta::Tick() noexcept
+{
+    // With zero-cross pulses coming, HalfCycle resets the count before it gets here; one missing half-cycle more
+    // than that and the ticker clocks them
+    const uint8_t limit = ZERO_CROSS ? HALF_CYCLE_TICKS + HALF_CYCLE_TICKS / 2 : HALF_CYCLE_TICKS;
+    if (++ticks_ >= limit)
+        HalfCycle();
+}
@@ -0,0 +1,40 @@
+#ifndef __SIGMA_DELTA_HPP
+#define __SIGMA_DELTA_HPP
+
+#include "pins.hpp"
+#include "settings.hpp"
+
+// Heater output stage that spreads the PID power over single mains half-cycles instead of the multi-second on/off
+// blocks of the time proportional window. A first order sigma-delta modulator decides for every half-cycle whether
+// the SSR conducts, so 30 % power is every third half-cycle rather than 0.9 s on and 2.1 s off.
+// The half-cycles are clocked by the Ticker. With ZERO_CROSS, a zero-cross detector on ZERO_CROSS_PIN clocks them
+// instead and the Ticker only takes over if its pulses stop. A zero-crossing SSR only switches at the zero crossings
+// anyway, so without a detector the half-cycles are merely not aligned, the number of conducting ones still adds up.
+// Enabled with HEATER_OUTPUT_SIGMA_DELTA.
+class SigmaDelta final
+{
+  public:
+    static constexpr const uint8_t HALF_CYCLE_TICKS = TICK_FREQUENCY / (2 * MAINS_FREQUENCY);
+
+    // Attaches the tick handler and with ZERO_CROSS the zero-cross interrupt
+    static void Begin() noexcept;
+
+    // Power from 0 to 1, taken over with the next half-cycle
+    static void SetPower(double Power) noexcept;
+
+    // Power in effect from 0 to 1
+    static double Power() noexcept { return level_ / 255.0; }
+
+    // Decides the SSR state for the next half-cycle, called at every zero crossing
+    static void HalfCycle() noexcept;
+
+    // Clocks the half-cycles while there is no zero-cross signal, done by the Ticker
+    static void Tick() noexcept;
+
+  private:
+    static volatile uint8_t level_;  // power in 1/255
+    static uint16_t accumulator_;
+    static uint8_t ticks_;           // ticks since the last half-cycle
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef __SNAPSHOT_HPP
+#define __SNAPSHOT_HPP
+
+#include "settings.hpp"
+
+// Last values reported to the app, each with the version it changed at, so a client that already has version V
+// only needs the fields changed after it (updateapp:since:V). Values are compared when the app asks, nothing is
+// tracked in between. The version starts at 0 on every boot: a client ahead of the current version gets everything.
+class Snapshot final
+{
+  public:
+    enum class Field : uint8_t
+    {
+        TurnedOn,
+        UnixTime,  // offset of the unix time to millis(), changes only when the clock is set or drifts
+        SetpointBrew,
+        SetpointSteam,
+        Temperature,
+        State,
+        Readiness,  // confidence of the heater readiness
+        Eta,        // seconds until the heater is ready
+        SetpointEco,
+        SleepTimeout,
+        PumpProfile,
+        TargetVolume,
+        PumpPressureLimit,
+        Pressure,
+        SetpointGroup,
+        GroupTemperature,
+        GroupEstimate,  // group temperature estimated from the boiler, see GroupObserver
+        Timers  // days, on, off and ready-by of each timer follow, see TimerField
+    };
+
+    // Field of a timer, Part 0: days, 1: on, 2: off, 3: ready-by
+    static constexpr uint8_t TimerField(uint8_t Timer, uint8_t Part)
+    {
+        return static_cast<uint8_t>(Field::Timers) + Timer * 4 + Part;
+    }
+
+    static constexpr const uint8_t FIELDS = static_cast<uint8_t>(Field::Timers) + NUMBER_OF_TIMERS * 4;
+
+    Snapshot() noexcept : values_{}, changedAt_{}, version_{0} {}
+
+    // Stores Value and gives the field a new version if it differs from the stored value by more than Deadband
+    void Set(uint8_t Field, long Value, long Deadband = 0) noexcept
+    {
+        const long difference = Value - values_[Field];
+        if (changedAt_[Field] && difference <= Deadband && -difference <= Deadband)
+            return;
+        values_[Field] = Value;
+        // 0 marks a field that was never set, skip it when the version wraps around
+        if (++version_ == 0)
+            version_ = 1;
+        changedAt_[Field] = version_;
+    }
+    void Set(enum Field Field, long Value, long Deadband = 0) noexcept
+    {
+        Set(static_cast<uint8_t>(Field), Value, Deadband);
+    }
+
+    // Whether the field changed after the client's version Since
+    bool ChangedSince(uint8_t Field, unsigned int Since) const noexcept { return changedAt_[Field] > Since; }
+    bool ChangedSince(enum Field Field, unsigned int Since) const noexcept
+    {
+        return ChangedSince(static_cast<uint8_t>(Field), Since);
+    }
+
+    // Version of the latest change
+    unsigned int Version() const noexcept { return version_; }
+
+  private:
+    long values_[FIELDS];
+    unsigned int changedAt_[FIELDS];
+    unsigned int version_;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "stateMachine.hpp"
+
+namespace
+{
+typedef enum StateMachine::State S;
+typedef StateMachine::Transition T;
+
+// Turn on to brew temperature / turn everything off / stop on an error
+constexpr const uint8_t ON = StateMachine::HeatBrew | StateMachine::ReportOn;
+constexpr const uint8_t OFF = StateMachine::HeatOff | StateMachine::PumpOff | StateMachine::ReportOff;
+constexpr const uint8_t FAIL = StateMachine::HeatOff | StateMachine::PumpOff;
+constexpr const uint8_t PUMP = StateMachine::TogglePump;
+constexpr const uint8_t BREW = StateMachine::HeatBrew;
+constexpr const uint8_t STEAM = StateMachine::HeatSteam;
+constexpr const uint8_t ECO = StateMachine::HeatEco;
+// The app turning the machine on stops a running pump and switches back to brewing
+constexpr const uint8_t APP_ON = StateMachine::HeatBrew | StateMachine::PumpOff | StateMachine::ReportOn;
+
+// Rows in the order of State starting with Error, columns in the order of Event:
+//    Click              ShortPress           LongPress      ButtonError     AppTurnOn
+//    AppTurnOff         TimerOn              TimerOff       HeaterReady     Fault
+//    Inactive           Activity
+// An error is only left by turning the machine off with a long press or from the app. A supervisor fault is latched
+// and keeps coming, so it brings the machine back into error right away. Only an idle machine goes to sleep. Any
+// input wakes it up: button and app events do so on their own, Activity covers the rest like the brew lever.
+constexpr const T TABLE[StateMachine::STATES][StateMachine::EVENTS] PROGMEM = {
+    // Error
+    {{S::Error, 0}, {S::Error, 0}, {S::Off, OFF}, {S::Error, 0}, {S::Error, 0},
+     {S::Off, OFF}, {S::Error, 0}, {S::Error, 0}, {S::Error, 0}, {S::Error, 0},
+     {S::Error, 0}, {S::Error, 0}},
+    // Off
+    {{S::HeatingUpBrew, ON}, {S::HeatingUpBrew, ON}, {S::Off, OFF}, {S::Error, FAIL}, {S::HeatingUpBrew, APP_ON},
+     {S::Off, OFF}, {S::HeatingUpBrew, ON}, {S::Off, 0}, {S::Off, 0}, {S::Error, FAIL},
+     {S::Off, 0}, {S::Off, 0}},
+    // Sleep
+    {{S::HeatingUpBrew, ON}, {S::HeatingUpBrew, ON}, {S::Off, OFF}, {S::Error, FAIL}, {S::HeatingUpBrew, APP_ON},
+     {S::Off, OFF}, {S::HeatingUpBrew, ON}, {S::Off, OFF}, {S::Sleep, 0}, {S::Error, FAIL},
+     {S::Sleep, 0}, {S::HeatingUpBrew, ON}},
+    // HeatingUpBrew
+    {{S::HeatingUpBrew, PUMP}, {S::HeatingUpSteam, STEAM}, {S::Off, OFF}, {S::Error, FAIL}, {S::HeatingUpBrew, APP_ON},
+     {S::Off, OFF}, {S::HeatingUpBrew, 0}, {S::Off, OFF}, {S::IdleBrew, 0}, {S::Error, FAIL},
+     {S::HeatingUpBrew, 0}, {S::HeatingUpBrew, 0}},
+    // IdleBrew
+    {{S::IdleBrew, PUMP}, {S::HeatingUpSteam, STEAM}, {S::Off, OFF}, {S::Error, FAIL}, {S::IdleBrew, APP_ON},
+     {S::Off, OFF}, {S::IdleBrew, 0}, {S::Off, OFF}, {S::IdleBrew, 0}, {S::Error, FAIL},
+     {S::Sleep, ECO}, {S::IdleBrew, 0}},
+    // HeatingUpSteam
+    {{S::HeatingUpSteam, PUMP}, {S::CoolingDown, BREW}, {S::Off, OFF}, {S::Error, FAIL}, {S::CoolingDown, APP_ON},
+     {S::Off, OFF}, {S::HeatingUpSteam, 0}, {S::Off, OFF}, {S::IdleSteam, 0}, {S::Error, FAIL},
+     {S::HeatingUpSteam, 0}, {S::HeatingUpSteam, 0}},
+    // IdleSteam
+    {{S::IdleSteam, PUMP}, {S::CoolingDown, BREW}, {S::Off, OFF}, {S::Error, FAIL}, {S::CoolingDown, APP_ON},
+     {S::Off, OFF}, {S::IdleSteam, 0}, {S::Off, OFF}, {S::IdleSteam, 0}, {S::Error, FAIL},
+     {S::IdleSteam, 0}, {S::IdleSteam, 0}},
+    // CoolingDown
+    {{S::CoolingDown, PUMP}, {S::HeatingUpSteam, STEAM}, {S::Off, OFF}, {S::Error, FAIL}, {S::CoolingDown, APP_ON},
+     {S::Off, OFF}, {S::CoolingDown, 0}, {S::Off, OFF}, {S::IdleBrew, 0}, {S::Error, FAIL},
+     {S::CoolingDown, 0}, {S::CoolingDown, 0}}};
+}  // namespace
+
+StateMachine::Transition StateMachine::Lookup(enum State From, Event Event) noexcept
+{
+    Transition transition;
+    memcpy_P(&transition, &TABLE[static_cast<int8_t>(From) + 1][static_cast<uint8_t>(Event)], sizeof(transition));
+    return transition;
+}
+
+StateMachine::Transition StateMachine::Dispatch(Event Event) noexcept
+{
+    const auto transition = Lookup(state_, Event);
+    if (transition.next == state_ && !transition.actions)
+        return transition;
+
+    LOG_VBM("State {} -> {} on event {}, actions {}", static_cast<int>(state_), static_cast<int>(transition.next),
+            static_cast<int>(Event), transition.actions)
+    log_[logHead_] = LogEntry{millis(), Event, state_, transition.next};
+    logHead_ = (logHead_ + 1) % STATE_LOG_SIZE;
+    if (logCount_ < STATE_LOG_SIZE)
+        ++logCount_;
+
+    state_ = transition.next;
+    return transition;
+}
@@ -0,0 +1,100 @@
+#ifndef __STATE_MACHINE_HPP
+#define __STATE_MACHINE_HPP
+
+#include "settings.hpp"
+
+// Machine states and the transitions between them. Every source (button, app, timer, heater) is turned into an
+// Event and looked up in a single [state][event] table in flash, which gives the next state and a bitmask of
+// actions the VBM has to carry out. Transitions that change something are kept in a small log (statelog command).
+class StateMachine final
+{
+  public:
+    enum class State : int8_t
+    {
+        Error = -1,
+        Off = 0,
+        Sleep,
+        HeatingUpBrew,
+        IdleBrew,
+        HeatingUpSteam,
+        IdleSteam,
+        CoolingDown
+    };
+
+    enum class Event : uint8_t
+    {
+        Click,        // short click of the switch button
+        ShortPress,   // switch button held for BUTTON_PRESS_SHORT
+        LongPress,    // switch button held for BUTTON_PRESS_LONG
+        ButtonError,  // button reported an error
+        AppTurnOn,    // turnon from the app
+        AppTurnOff,   // turnoff from the app
+        TimerOn,      // a clock timer wants the machine on
+        TimerOff,     // a clock timer wants the machine off
+        HeaterReady,  // the heater settled at its setpoint, see Readiness
+        Fault,        // the supervisor tripped, see Supervisor
+        Inactive,     // no input for SLEEP_TIMEOUT minutes
+        Activity      // any input, dispatched after the event of the input itself
+    };
+
+    // Actions of a transition, carried out in this order
+    enum Action : uint8_t
+    {
+        None = 0,
+        HeatOff = 1 << 0,
+        HeatBrew = 1 << 1,
+        HeatSteam = 1 << 2,
+        PumpOff = 1 << 3,
+        TogglePump = 1 << 4,
+        ReportOn = 1 << 5,  // tell the app the machine is on (>turnedon:1)
+        ReportOff = 1 << 6,  // tell the app the machine is off (>turnedon:0)
+        HeatEco = 1 << 7     // heat to the eco setpoint
+    };
+
+    struct Transition
+    {
+        State next;
+        uint8_t actions;
+    };
+
+    struct LogEntry
+    {
+        unsigned long at;  // millis() of the transition
+        Event event;
+        State from;
+        State to;
+    };
+
+    static constexpr const uint8_t STATES = 8;
+    static constexpr const uint8_t EVENTS = 12;
+
+    StateMachine() noexcept : state_{State::Off}, logHead_{0}, logCount_{0} {}
+
+    // Transition of the table for an event in a state, the state itself without actions if the event does not apply
+    static Transition Lookup(State From, Event Event) noexcept;
+
+    // Moves to the next state and returns the transition.
+    // Transitions that change the state or have actions are logged.
+    Transition Dispatch(Event Event) noexcept;
+
+    State State() const noexcept { return state_; }
+
+    // Number of logged transitions, at most STATE_LOG_SIZE
+    uint8_t LogCount() const noexcept { return logCount_; }
+
+    // Logged transition, 0 is the oldest
+    const LogEntry& Log(uint8_t Index) const noexcept
+    {
+        const uint8_t position = logHead_ + STATE_LOG_SIZE - logCount_ + Index;
+        return log_[position % STATE_LOG_SIZE];
+    }
+
+  private:
+    enum State state_;
+
+    LogEntry log_[STATE_LOG_SIZE];
+    uint8_t logHead_;  // where the next entry goes
+    uint8_t logCount_;
+};
+
+#endif
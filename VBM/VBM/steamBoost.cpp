@@ -0,0 +1,88 @@
+#include "steamBoost.hpp"
+
+SteamBoost::SteamBoost() noexcept
+    : phase_{Phase::Idle},
+      drawing_{false},
+      drawSince_{0},
+      phaseSince_{0},
+      lastBoost_{0},
+      lastRecovery_{0},
+      report_{false}
+{
+}
+
+void SteamBoost::Update(double Slope, double Temperature, double Setpoint, bool Steaming, bool Settled,
+                        unsigned long Now) noexcept
+{
+    if (!Steaming)
+    {
+        drawing_ = false;
+        if (phase_ != Phase::Idle)
+            Finish(Now);
+        return;
+    }
+
+    switch (phase_)
+    {
+        case Phase::Boosting:
+            if (Slope >= 0 || Now - phaseSince_ >= STEAM_BOOST_MAX_TIME)
+            {
+                lastBoost_ = Now - phaseSince_;
+                LOG_HEATER("Steam boost ended after {} ms", lastBoost_)
+                phase_ = Phase::Recovering;
+                phaseSince_ = Now;
+            }
+            return;
+
+        case Phase::Recovering:
+            if (Temperature > Setpoint - IS_READY_RANGE)
+            {
+                Finish(Now);
+                return;
+            }
+            break;
+
+        case Phase::Idle:
+        default:
+            if (!Settled)
+                return;
+            break;
+    }
+
+    // Also while recovering, the next draw may start before the boiler is back
+    if (Slope >= -STEAM_DRAW_SLOPE)
+        drawing_ = false;
+    else if (!drawing_)
+    {
+        drawing_ = true;
+        drawSince_ = Now;
+    }
+    else if (Now - drawSince_ >= STEAM_DRAW_DETECT_TIME)
+    {
+        LOG_HEATER("Steam draw detected, slope {}", Slope)
+        drawing_ = false;
+        phase_ = Phase::Boosting;
+        phaseSince_ = Now;
+    }
+}
+
+void SteamBoost::Finish(unsigned long Now) noexcept
+{
+    if (phase_ == Phase::Boosting)
+    {
+        lastBoost_ = Now - phaseSince_;
+        lastRecovery_ = 0;
+    }
+    else
+        lastRecovery_ = Now - phaseSince_;
+    LOG_HEATER("Steam recovered after {} ms", lastRecovery_)
+    phase_ = Phase::Idle;
+    report_ = true;
+}
+
+bool SteamBoost::HasNewReport() noexcept
+{
+    const bool report = report_;
+    report_ = false;
+    return report;
+}
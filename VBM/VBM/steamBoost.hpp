@@ -0,0 +1,58 @@
+#ifndef __STEAM_BOOST_HPP
+#define __STEAM_BOOST_HPP
+
+#include "settings.hpp"
+
+// Detects a steam draw and boosts the heater through it. A single boiler cannot keep up with the steam wand: once
+// the boiler settled at steam temperature, a slope below -STEAM_DRAW_SLOPE for STEAM_DRAW_DETECT_TIME with the brew
+// lever up is taken as a draw. The heater then runs at full power up to the setpoint raised by STEAM_BOOST_OFFSET
+// until the slope is no longer negative, at most for STEAM_BOOST_MAX_TIME. The boost duration and the time from its
+// end until the temperature is back in range are reported.
+class SteamBoost final
+{
+  public:
+    enum class Phase : uint8_t
+    {
+        Idle,
+        Boosting,
+        Recovering  // boost ended, waiting for the temperature to be back in range
+    };
+
+    SteamBoost() noexcept;
+
+    // Feeds a sample. Steaming: the heater holds steam temperature and the lever is up, Settled: it was ready at
+    // steam temperature since then, only then a sag is a draw and not the heat-up.
+    void Update(double Slope, double Temperature, double Setpoint, bool Steaming, bool Settled,
+                unsigned long Now) noexcept;
+
+    Phase Phase() const noexcept { return phase_; }
+
+    // Setpoint the heater runs at full power up to while boosting, never below Setpoint
+    static double BoostSetpoint(double Setpoint) noexcept
+    {
+        const double boosted = Setpoint + STEAM_BOOST_OFFSET;
+        const double limited = boosted < MAX_SETPOINT ? boosted : MAX_SETPOINT;
+        return limited > Setpoint ? limited : Setpoint;
+    }
+
+    // Whether a boost and its recovery ended since the last call
+    bool HasNewReport() noexcept;
+
+    // Milliseconds of the last boost and of the recovery after it
+    unsigned long LastBoost() const noexcept { return lastBoost_; }
+    unsigned long LastRecovery() const noexcept { return lastRecovery_; }
+
+  private:
+    // Ends a boost or a recovery and reports it
+    void Finish(unsigned long Now) noexcept;
+
+    enum Phase phase_;
+    bool drawing_;  // slope below -STEAM_DRAW_SLOPE since drawSince_
+    unsigned long drawSince_;
+    unsigned long phaseSince_;
+    unsigned long lastBoost_;
+    unsigned long lastRecovery_;
+    bool report_;
+};
+
+#endif
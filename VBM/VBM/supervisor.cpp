@@ -0,0 +1,99 @@
+#include "supervisor.hpp"
+
+#include "ticker.hpp"
+
+#ifdef __AVR__
+#include <avr/wdt.h>
+#endif
+
+volatile uint8_t Supervisor::fault_ = static_cast<uint8_t>(Fault::None);
+volatile uint16_t Supervisor::ticksSinceSample_ = 0;
+volatile bool Supervisor::enforced_ = false;
+volatile unsigned long Supervisor::trippedAt_ = 0;
+volatile uint16_t Supervisor::tickLatency_ = 0;
+double Supervisor::lastTemperature_ = 0;
+unsigned long Supervisor::lastSampleAt_ = 0;
+unsigned long Supervisor::worstSampleInterval_ = 0;
+
+void Supervisor::Begin() noexcept
+{
+    noInterrupts();
+    fault_ = static_cast<uint8_t>(Fault::None);
+    ticksSinceSample_ = 0;
+    enforced_ = false;
+    interrupts();
+    lastSampleAt_ = 0;
+    worstSampleInterval_ = 0;
+
+    static bool attached = false;
+    if (!attached)
+        attached = Ticker::Attach(&Supervisor::Tick);
+#ifdef __AVR__
+    wdt_enable(WATCHDOG_TIMEOUT);
+#endif
+}
+
+void Supervisor::Sample(double Temperature, uint8_t SensorFault) noexcept
+{
+    noInterrupts();
+    ticksSinceSample_ = 0;
+    interrupts();
+
+    const auto now = micros();
+    const auto interval = now - lastSampleAt_;
+    const bool first = !lastSampleAt_;
+    if (!first && interval > worstSampleInterval_)
+        worstSampleInterval_ = interval;
+
+    if (SensorFault || Temperature < SUPERVISOR_MIN_TEMP)
+        Trip(Fault::Sensor);
+    else if (Temperature > SUPERVISOR_MAX_TEMP)
+        Trip(Fault::OverTemperature);
+    else if (!first && fabs(Temperature - lastTemperature_) * 1000000.0 > SUPERVISOR_MAX_SLOPE * interval)
+        Trip(Fault::Slope);
+
+    lastTemperature_ = Temperature;
+    lastSampleAt_ = now ? now : 1;
+}
+
+void Supervisor::Trip(Fault Fault) noexcept
+{
+    if (fault_ != static_cast<uint8_t>(Fault::None))
+        return;
+    // The tick handler starts enforcing once it sees the fault, so the time has to be there first
+    trippedAt_ = micros();
+    fault_ = static_cast<uint8_t>(Fault);
+}
+
+unsigned long Supervisor::WorstReactionLatency() noexcept
+{
+    noInterrupts();
+    const unsigned long tickLatency = enforced_ ? tickLatency_ : 1000000UL / TICK_FREQUENCY;
+    interrupts();
+    return worstSampleInterval_ + tickLatency;
+}
+
+void Supervisor::Tick() noexcept
+{
+    if (ticksSinceSample_ < 0xFFFF)
+        ++ticksSinceSample_;
+    const bool stale = ticksSinceSample_ > static_cast<unsigned long>(SUPERVISOR_SAMPLE_TIMEOUT) * TICK_FREQUENCY / 1000;
+    if (stale)
+        Trip(Fault::Stale);
+
+    if (fault_ != static_cast<uint8_t>(Fault::None))
+    {
+        BoilerSsrPin::Low();
+        if (!enforced_)
+        {
+            const unsigned long latency = micros() - trippedAt_;
+            tickLatency_ = latency < 0xFFFF ? latency : 0xFFFF;
+            enforced_ = true;
+        }
+    }
+
+#ifdef __AVR__
+    if (!stale)
+        wdt_reset();
+#endif
+}
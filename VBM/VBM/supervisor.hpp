@@ -0,0 +1,55 @@
+#ifndef __SUPERVISOR_HPP
+#define __SUPERVISOR_HPP
+
+#include "pins.hpp"
+#include "settings.hpp"
+
+// Boiler safety independent of the heater and its PID. Every temperature sample is checked against SUPERVISOR_MAX_TEMP,
+// SUPERVISOR_MAX_SLOPE and the MAX31865 fault register, and a tick handler trips if no sample arrived within
+// SUPERVISOR_SAMPLE_TIMEOUT. A trip is latched until the next reset: from then on the tick handler holds the boiler
+// SSR low on every tick, whatever the heater writes. The tick handler also feeds the AVR watchdog as long as samples
+// keep arriving, so a hung main loop resets the board after another WATCHDOG_TIMEOUT.
+class Supervisor final
+{
+  public:
+    enum class Fault : uint8_t
+    {
+        None = 0,
+        OverTemperature,  // above SUPERVISOR_MAX_TEMP
+        Slope,            // temperature changed faster than SUPERVISOR_MAX_SLOPE
+        Sensor,           // MAX31865 reported a fault or the reading is below SUPERVISOR_MIN_TEMP
+        Stale             // no sample for SUPERVISOR_SAMPLE_TIMEOUT
+    };
+
+    // Starts supervising without a fault, attaches the tick handler and enables the watchdog.
+    // Call before Ticker::Begin, safe to call more than once.
+    static void Begin() noexcept;
+
+    // Checks a new boiler temperature sample, SensorFault is the MAX31865 fault register
+    static void Sample(double Temperature, uint8_t SensorFault) noexcept;
+
+    static Fault Tripped() noexcept { return static_cast<Fault>(fault_); }
+
+    // Worst case time in microseconds from a fault to the SSR being low: the longest time between two samples plus
+    // the time the tick handler took to react. Before a trip the reaction is assumed to take a full tick.
+    static unsigned long WorstReactionLatency() noexcept;
+
+    // Holds the SSR low after a trip and watches for stale samples, done by the Ticker
+    static void Tick() noexcept;
+
+  private:
+    static volatile uint8_t fault_;
+    static volatile uint16_t ticksSinceSample_;
+    static volatile bool enforced_;  // the tick handler pulled the SSR low after the trip
+    static volatile unsigned long trippedAt_;  // micros() of the trip
+    static volatile uint16_t tickLatency_;  // microseconds from the trip to the SSR low
+
+    static double lastTemperature_;
+    static unsigned long lastSampleAt_;  // micros() of the last sample, 0 before the first one
+    static unsigned long worstSampleInterval_;
+
+    // Latches the first fault
+    static void Trip(Fault Fault) noexcept;
+};
+
+#endif
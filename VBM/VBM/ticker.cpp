@@ -0,0 +1,37 @@
+#include "ticker.hpp"
+
+Ticker::Handler Ticker::handlers_[Ticker::MAX_HANDLERS] = {};
+volatile uint8_t Ticker::numberOfHandlers_ = 0;
+
+bool Ticker::Attach(Handler TickHandler) noexcept
+{
+    if (numberOfHandlers_ == MAX_HANDLERS)
+        return false;
+    // The handler must be in place before the interrupt sees the new count
+    handlers_[numberOfHandlers_] = TickHandler;
+    ++numberOfHandlers_;
+    return true;
+}
+
+#ifdef __AVR__
+
+ISR(TIMER2_COMPA_vect) { Ticker::Tick(); }
+
+void Ticker::Begin() noexcept
+{
+    noInterrupts();
+    // CTC mode, clk/64 --> 250 kHz at 16 MHz, compare match every 250 counts for 1 kHz
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS22);
+    OCR2A = F_CPU / 64 / TICK_FREQUENCY - 1;
+    TCNT2 = 0;
+    TIMSK2 |= _BV(OCIE2A);
+    interrupts();
+}
+
+#else
+
+// Host build: ticks are driven by the simulation calling Ticker::Tick
+void Ticker::Begin() noexcept {}
+
+#endif
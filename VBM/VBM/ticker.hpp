@@ -0,0 +1,35 @@
+#ifndef __TICKER_HPP
+#define __TICKER_HPP
+
+#include "settings.hpp"
+
+// Periodic interrupt at TICK_FREQUENCY on Timer2 for work that needs exact timing regardless of how long the main
+// loop takes (blocking sensor reads, serial output). Handlers run in interrupt context: keep them short, only touch
+// volatile or interrupt protected data and never use Serial or String in them.
+// Note: Timer2 also drives tone() and the PWM of pins 3 and 11, which therefore cannot be used with analogWrite.
+class Ticker final
+{
+  public:
+    typedef void (*Handler)();
+
+    static constexpr const uint8_t MAX_HANDLERS = 4;
+
+    // Starts the hardware timer, safe to call more than once
+    static void Begin() noexcept;
+
+    // Registers a handler to be called on every tick. Returns false if all slots are taken.
+    static bool Attach(Handler TickHandler) noexcept;
+
+    // Calls all handlers, done by the timer interrupt. On host, call it to simulate a tick.
+    static void Tick() noexcept
+    {
+        for (uint8_t i = 0; i < numberOfHandlers_; ++i)
+            handlers_[i]();
+    }
+
+  private:
+    static Handler handlers_[MAX_HANDLERS];
+    static volatile uint8_t numberOfHandlers_;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "txQueue.hpp"
+
+// The UART buffer of the Nano holds 63 bytes, a line must fit at once
+static_assert(TX_LINE_LENGTH + 2 < 64, "TX_LINE_LENGTH does not fit the UART buffer");
+static_assert(TX_QUEUE_SIZE > TX_LINE_LENGTH, "TX_QUEUE_SIZE must hold at least one line");
+
+char TxQueue::buffer_[TX_QUEUE_SIZE];
+unsigned int TxQueue::head_ = 0;
+unsigned int TxQueue::used_ = 0;
+unsigned int TxQueue::dropped_ = 0;
+
+void TxQueue::Push(const char* Line, uint8_t Length) noexcept
+{
+    if (Length > TX_LINE_LENGTH)
+        Length = TX_LINE_LENGTH;
+
+    // Make room by handing lines to the UART first, drop only what it cannot take right now
+    if (used_ + Length + 1 > TX_QUEUE_SIZE)
+        Flush(0xFF);
+    while (used_ + Length + 1 > TX_QUEUE_SIZE)
+    {
+        Pop();
+        ++dropped_;
+    }
+
+    auto tail = head_ + used_;
+    if (tail >= TX_QUEUE_SIZE)
+        tail -= TX_QUEUE_SIZE;
+    buffer_[tail] = static_cast<char>(Length);
+    for (uint8_t i = 0; i < Length; ++i)
+    {
+        if (++tail == TX_QUEUE_SIZE)
+            tail = 0;
+        buffer_[tail] = Line[i];
+    }
+    used_ += Length + 1;
+}
+
+void TxQueue::Flush(uint8_t Budget) noexcept
+{
+    unsigned int sent = 0;
+    while (used_)
+    {
+        const uint8_t length = static_cast<uint8_t>(buffer_[head_]);
+        const unsigned int lineBytes = length + 2;
+        // The first line is sent even if it exceeds the budget, otherwise a long line would never go out
+        if ((sent && sent + lineBytes > Budget) || Serial.availableForWrite() < static_cast<int>(lineBytes))
+            return;
+
+        // Write the line in at most two pieces, the second one if it wraps around the end of the buffer
+        const unsigned int start = head_ + 1 < TX_QUEUE_SIZE ? head_ + 1 : 0;
+        const unsigned int first = TX_QUEUE_SIZE - start < length ? TX_QUEUE_SIZE - start : length;
+        Serial.write(reinterpret_cast<const uint8_t*>(buffer_ + start), first);
+        if (first < length)
+            Serial.write(reinterpret_cast<const uint8_t*>(buffer_), length - first);
+        Serial.write("\r\n");
+
+        sent += lineBytes;
+        Pop();
+    }
+}
+
+void TxQueue::Pop() noexcept
+{
+    const unsigned int lineBytes = static_cast<uint8_t>(buffer_[head_]) + 1;
+    head_ += lineBytes;
+    if (head_ >= TX_QUEUE_SIZE)
+        head_ -= TX_QUEUE_SIZE;
+    used_ -= lineBytes;
+}
+
+char TxLine::buffer_[TX_LINE_LENGTH + 1];
+uint8_t TxLine::length_ = 0;
+
+TxLine& TxLine::AppendP(PGM_P Text) noexcept
+{
+    char character;
+    while (length_ < TX_LINE_LENGTH && (character = pgm_read_byte(Text++)))
+        buffer_[length_++] = character;
+    return *this;
+}
+
+TxLine& TxLine::Append(const char* Text) noexcept
+{
+    while (length_ < TX_LINE_LENGTH && *Text)
+        buffer_[length_++] = *Text++;
+    return *this;
+}
+
+TxLine& TxLine::Append(long Value) noexcept
+{
+    char number[12];
+    return Append(ltoa(Value, number, 10));
+}
+
+TxLine& TxLine::Append(double Value, uint8_t Decimals) noexcept
+{
+    // dtostrf has no length limit, keep large values from overflowing
+    char number[16];
+    if (Value > 1e9 || Value < -1e9)
+        return Append("ovf");
+    return Append(dtostrf(Value, 1, Decimals, number));
+}
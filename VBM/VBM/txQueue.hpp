@@ -0,0 +1,63 @@
+#ifndef __TX_QUEUE_HPP
+#define __TX_QUEUE_HPP
+
+#include "settings.hpp"
+
+// Outbound serial lines. Lines are queued in a static ring buffer and handed to the UART only when its buffer can
+// take a whole line, so sending never blocks the control loop on the 57600 baud link. If the queue is full, the
+// oldest lines are dropped: telemetry is sent again anyway and the newest values are the interesting ones.
+// Only use it from the main loop, not from interrupts.
+class TxQueue final
+{
+  public:
+    // Queues Line followed by a line end, lines longer than TX_LINE_LENGTH are truncated.
+    // If the queue is full, lines go to the UART as far as it has room and then the oldest lines are dropped.
+    static void Push(const char* Line, uint8_t Length) noexcept;
+    static void Push(const char* Line) noexcept { Push(Line, strlen(Line)); }
+
+    // Hands complete lines to the UART as long as they fit into its buffer and Budget bytes, call once per loop
+    static void Flush(uint8_t Budget = TX_BYTES_PER_LOOP) noexcept;
+
+    // Bytes waiting in the queue
+    static unsigned int Pending() noexcept { return used_; }
+
+    // Bytes left in the queue, a line takes its length plus one
+    static unsigned int Free() noexcept { return TX_QUEUE_SIZE - used_; }
+
+    // Lines dropped since boot because the queue was full
+    static unsigned int Dropped() noexcept { return dropped_; }
+
+  private:
+    // Removes the oldest line
+    static void Pop() noexcept;
+
+    // Lines are stored as a length byte followed by the characters, the line end is added when sending
+    static char buffer_[TX_QUEUE_SIZE];
+    static unsigned int head_;
+    static unsigned int used_;
+    static unsigned int dropped_;
+};
+
+// Formats one line into a static buffer without touching the heap and queues it with Send.
+// There is only one buffer: build and send one line at a time.
+class TxLine final
+{
+  public:
+    TxLine() noexcept { length_ = 0; }
+
+    // Appends a string from flash, e.g. Append(PSTR("temp"))
+    TxLine& AppendP(PGM_P Text) noexcept;
+
+    TxLine& Append(const char* Text) noexcept;
+    TxLine& Append(long Value) noexcept;
+    TxLine& Append(double Value, uint8_t Decimals) noexcept;
+
+    // Queues the line on the TxQueue
+    void Send() noexcept { TxQueue::Push(buffer_, length_); }
+
+  private:
+    static char buffer_[TX_LINE_LENGTH + 1];
+    static uint8_t length_;
+};
+
+#endif
@@ -1,20 +1,51 @@
 #include "vbm.hpp"
 
+namespace
+{
+// Lines of an app update after one per snapshot field: the boot status, the RTC readout and the version
+constexpr const uint8_t UPDATE_BOOT_STATUS = Snapshot::FIELDS;
+constexpr const uint8_t UPDATE_RTC = Snapshot::FIELDS + 1;
+constexpr const uint8_t UPDATE_VERSION = Snapshot::FIELDS + 2;
+constexpr const uint8_t UPDATE_DONE = Snapshot::FIELDS + 3;
+// Most lines one step of the update sends, the boot status and the RTC readout take 3
+constexpr const uint8_t UPDATE_STEP_LINES = 3;
+static_assert(TX_QUEUE_SIZE > (UPDATE_STEP_LINES + 1) * (TX_LINE_LENGTH + 1),
+              "TX_QUEUE_SIZE must hold the longest step of an app update and a line of telemetry");
+static_assert(UPDATE_DONE < 0xFF, "the app update counts its lines in a byte");
+}  // namespace
+
 VBM::VBM()
-    : heater_(new Heater()),
-      led_(new LED()),
-      button_(new Button()),
-      buttonBrew_(new ButtonBrew()),
-      communicator_(new Communicator()),
-      machineState_{State::Off},
-      clock_{new Clock()},
-      eeprom_{new Eeprom()},
+    : heater_(),
+      led_(),
+      button_(),
+      buttonBrew_(),
+      communicator_(),
+      eeprom_(),
+      clock_(),
+      energyMeter_(),
+      machine_(),
       currentTime_{0},
+      bootTime_{0},
+      temperatureRecordedAt_{0},
+      lastActivity_{0},
+      flowReportedAt_{0},
+      updateSince_{0},
+      updateLine_{UPDATE_DONE},
+      blackBoxLine_{FLIGHT_RECORDER_SIZE},
       pumpOn_{false},
-      wasBrewing_{false}
+      wasBrewing_{false},
+      faultReported_{false},
+      pumpProfile_{0}
 {
-    pinMode(PUMP_SSR_PIN, OUTPUT);
-    digitalWrite(PUMP_SSR_PIN, pumpOn_);
+    // First thing, so the recording of a run ended by the watchdog is saved before anything can overwrite it
+    FlightRecorder::Begin(FlightRecorder::ResetFlags());
+
+    // Safety before anything that talks to peripherals: the SSRs are low until the first heater update and every
+    // probe below has a timeout, so a missing part can neither hang nor heat the machine.
+    PumpSsrPin::Init();
+    PumpProfile::Begin();
+    FlowMeter::Begin();
+    PressureSensor::Begin();
 
     if (DISABLE_HEATER)
         Serial.println(
@@ -26,48 +57,392 @@ VBM::VBM()
             "false for normal use!");
 
 #if INITIALIZE_EEPROM
-    eeprom_->Save(Eeprom::Parameter::SetpointBrew, SETPOINT_BREW_TEMP);
-    eeprom_->Save(Eeprom::Parameter::SetpointSteam, SETPOINT_STEAM_TEMP);
-    eeprom_->Save(Eeprom::Parameter::Timer1Days, 0);
-    eeprom_->Save(Eeprom::Parameter::Timer1TurnOn, 0);
-    eeprom_->Save(Eeprom::Parameter::Timer1TurnOff, 0);
+    eeprom_.Save(Eeprom::Parameter::SetpointBrew, SETPOINT_BREW_TEMP);
+    eeprom_.Save(Eeprom::Parameter::SetpointSteam, SETPOINT_STEAM_TEMP);
+    eeprom_.Save(Eeprom::Parameter::SetpointEco, SETPOINT_ECO_TEMP);
+    eeprom_.Save(Eeprom::Parameter::SleepTimeout, SLEEP_TIMEOUT);
+    eeprom_.Save(Eeprom::Parameter::HeaterWattage, HEATER_WATTAGE);
+    eeprom_.Save(Eeprom::Parameter::TargetVolume, TARGET_VOLUME);
+    eeprom_.Save(Eeprom::Parameter::PumpPressureLimit, PUMP_PRESSURE_LIMIT);
+    eeprom_.Save(Eeprom::Parameter::SetpointGroup, SETPOINT_GROUP_TEMP);
+    for (uint8_t timer = 0; timer < NUMBER_OF_TIMERS; ++timer)
+    {
+        eeprom_.Save(Eeprom::Parameter::TimerDays, timer, static_cast<uint8_t>(0));
+        eeprom_.Save(Eeprom::Parameter::TimerTurnOn, timer, static_cast<uint16_t>(0));
+        eeprom_.Save(Eeprom::Parameter::TimerTurnOff, timer, static_cast<uint16_t>(0));
+        eeprom_.Save(Eeprom::Parameter::TimerReadyBy, timer, static_cast<uint8_t>(0));
+    }
 #endif
 
+    if (!clock_.Begin())
+        communicator_.SendMessageOnce("DS3231 not found, running without timers");
+
     // Load eeprom parameters with user set parameters as fallback if desired, for debugging sometimes not so smart
 #if LOAD_INITIAL_PARAMETERS_FROM_EEPROM
-    eeprom_->Load(Eeprom::Parameter::SetpointBrew, SETPOINT_BREW_TEMP);
-    eeprom_->Load(Eeprom::Parameter::SetpointSteam, SETPOINT_STEAM_TEMP);
+    eeprom_.Load(Eeprom::Parameter::SetpointBrew, SETPOINT_BREW_TEMP);
+    eeprom_.Load(Eeprom::Parameter::SetpointSteam, SETPOINT_STEAM_TEMP);
+    // Added later, an erased eeprom reads as NaN and 0xFFFF
+    float setpointEco = 0;
+    if (eeprom_.Load(Eeprom::Parameter::SetpointEco, setpointEco) && setpointEco == setpointEco)
+        SETPOINT_ECO_TEMP = setpointEco;
+    uint16_t sleepTimeout = 0;
+    if (eeprom_.Load(Eeprom::Parameter::SleepTimeout, sleepTimeout) && sleepTimeout != 0xFFFF)
+        SLEEP_TIMEOUT = sleepTimeout;
+    float heatingRate = 0;
+    if (eeprom_.Load(Eeprom::Parameter::HeatingRate, heatingRate) && heatingRate == heatingRate)
+        heater_.SetHeatingRate(heatingRate);
+    uint16_t heaterWattage = 0;
+    if (eeprom_.Load(Eeprom::Parameter::HeaterWattage, heaterWattage) && heaterWattage != 0xFFFF)
+        HEATER_WATTAGE = heaterWattage;
+    uint16_t targetVolume = 0;
+    if (eeprom_.Load(Eeprom::Parameter::TargetVolume, targetVolume) && targetVolume != 0xFFFF)
+        TARGET_VOLUME = targetVolume;
+    float pressureLimit = 0;
+    if (eeprom_.Load(Eeprom::Parameter::PumpPressureLimit, pressureLimit) && pressureLimit == pressureLimit)
+        PUMP_PRESSURE_LIMIT = pressureLimit;
+    float setpointGroup = 0;
+    if (eeprom_.Load(Eeprom::Parameter::SetpointGroup, setpointGroup) && setpointGroup == setpointGroup)
+        SETPOINT_GROUP_TEMP = setpointGroup;
 
     // Initialize clock parameters
-    byte daysTimer1 = 0;
-    eeprom_->Load(Eeprom::Parameter::Timer1Days, daysTimer1);
-    clock_->SetDays(daysTimer1);
-    unsigned long int timer1TurnOn = 0;
-    if (eeprom_->Load(Eeprom::Parameter::Timer1TurnOn, timer1TurnOn) && timer1TurnOn)
-        clock_->SetTurnOnAt(timer1TurnOn);
-    unsigned long int timer1TurnOff = 0;
-    if (eeprom_->Load(Eeprom::Parameter::Timer1TurnOff, timer1TurnOff) && timer1TurnOff)
-        clock_->SetTurnOffAt(timer1TurnOff);
+    MigrateSingleTimer();
+    for (uint8_t timer = 0; timer < clock_.NumberOfTimers(); ++timer)
+    {
+        uint8_t days = 0;
+        if (eeprom_.Load(Eeprom::Parameter::TimerDays, timer, days))
+            clock_.SetDays(days, timer);
+        uint16_t turnOn = 0;
+        uint8_t readyBy = 0;
+        eeprom_.Load(Eeprom::Parameter::TimerReadyBy, timer, readyBy);
+        if (eeprom_.Load(Eeprom::Parameter::TimerTurnOn, timer, turnOn) && turnOn)
+        {
+            // Erased eeprom of older versions reads as 0xFF, which is a plain timer
+            if (readyBy == 1)
+                clock_.SetReadyBy(turnOn, timer);
+            else
+                clock_.SetTurnOnAt(turnOn, timer);
+        }
+        uint16_t turnOff = 0;
+        if (eeprom_.Load(Eeprom::Parameter::TimerTurnOff, timer, turnOff) && turnOff)
+            clock_.SetTurnOffAt(turnOff, timer);
+    }
 
         // TODO: Continue
 
 #endif
+
+    eeprom_.Load(Eeprom::Parameter::PumpProfile, pumpProfile_);
+    LoadPumpProfile();
+    energyMeter_.Begin();
+
+    // Armed last: the watchdog and the stale check are meant for the main loop, the boot above can block on RTC
+    // timeouts and eeprom writes for a good part of WATCHDOG_TIMEOUT. The supervisor watches from the first sample on.
+    Supervisor::Begin();
+    // All tick handlers are attached by now
+    Ticker::Begin();
+    if (!heater_.Begin())
+        communicator_.SendMessageOnce("Boiler sensor missing or faulty");
 }
 
-VBM::~VBM()
+void VBM::LoadPumpProfile() noexcept
 {
-    delete heater_;
-    delete led_;
-    delete button_;
-    delete buttonBrew_;
-    delete communicator_;
-    delete eeprom_;
-    delete clock_;
+    // Erased eeprom reads as 0xFF
+    if (pumpProfile_ > PUMP_PROFILES)
+        pumpProfile_ = 0;
+    for (uint8_t i = 0; i < PUMP_PROFILE_SEGMENTS; ++i)
+        PumpProfile::SetSegment(i, pumpProfile_ ? LoadSegment((pumpProfile_ - 1) * PUMP_PROFILE_SEGMENTS + i)
+                                                : PumpProfile::Segment{0, 0});
 }
 
-String VBM::StateToString() const noexcept
+PumpProfile::Segment VBM::LoadSegment(uint8_t Index) const noexcept
 {
-    switch (machineState_)
+    uint16_t packed = 0;
+    eeprom_.Load(Eeprom::Parameter::PumpSegment, Index, packed);
+    const PumpProfile::Segment segment{static_cast<uint8_t>(packed), static_cast<uint8_t>(packed >> 8)};
+    return PumpProfile::IsEnd(segment) ? PumpProfile::Segment{0, 0} : segment;
+}
+
+bool VBM::SaveSegment(uint8_t Index, const PumpProfile::Segment& Segment) noexcept
+{
+    const uint16_t packed = static_cast<uint16_t>(Segment.time) << 8 | Segment.duty;
+    return eeprom_.Save(Eeprom::Parameter::PumpSegment, Index, packed);
+}
+
+void VBM::SendPumpProfiles() const noexcept
+{
+    for (uint8_t profile = 0; profile < PUMP_PROFILES; ++profile)
+    {
+        TxLine line;
+        line.AppendP(PSTR(">profile")).Append(static_cast<long>(profile + 1)).AppendP(PSTR(":"));
+        for (uint8_t i = 0; i < PUMP_PROFILE_SEGMENTS; ++i)
+        {
+            const auto segment = LoadSegment(profile * PUMP_PROFILE_SEGMENTS + i);
+            if (i)
+                line.AppendP(PSTR(","));
+            line.Append(static_cast<long>(segment.duty)).AppendP(PSTR(",")).Append(static_cast<long>(segment.time));
+        }
+        line.Send();
+    }
+}
+
+void VBM::MigrateSingleTimer() noexcept
+{
+    // Timers are stored compactly since there are several of them. An erased timer block (0xFF, days only use 7
+    // bits) means this eeprom still holds the single timer of older versions, take it over as first timer.
+    uint8_t days = 0;
+    eeprom_.Load(Eeprom::Parameter::TimerDays, 0, days);
+    if (days != 0xFF)
+        return;
+
+    LOG_VBM("Migrating single timer to timer 1")
+    uint8_t legacyDays = 0;
+    unsigned long int legacyTurnOn = 0;
+    unsigned long int legacyTurnOff = 0;
+    eeprom_.Load(Eeprom::Parameter::Timer1Days, legacyDays);
+    eeprom_.Load(Eeprom::Parameter::Timer1TurnOn, legacyTurnOn);
+    eeprom_.Load(Eeprom::Parameter::Timer1TurnOff, legacyTurnOff);
+    const bool legacyValid = legacyDays != 0xFF && legacyTurnOn < 24 * 60 && legacyTurnOff < 24 * 60;
+    for (uint8_t timer = 0; timer < NUMBER_OF_TIMERS; ++timer)
+    {
+        const bool takeOver = timer == 0 && legacyValid;
+        eeprom_.Save(Eeprom::Parameter::TimerDays, timer, static_cast<uint8_t>(takeOver ? legacyDays : 0));
+        eeprom_.Save(Eeprom::Parameter::TimerTurnOn, timer, static_cast<uint16_t>(takeOver ? legacyTurnOn : 0));
+        eeprom_.Save(Eeprom::Parameter::TimerTurnOff, timer, static_cast<uint16_t>(takeOver ? legacyTurnOff : 0));
+    }
+}
+
+void VBM::UpdateApp(unsigned int Since) noexcept
+{
+    RefreshSnapshot();
+    // A client from before a reboot or a wrap around of the version gets everything
+    if (Since > snapshot_.Version())
+        Since = 0;
+    updateSince_ = Since;
+    updateLine_ = 0;
+    SendUpdate();
+}
+
+void VBM::SendUpdate() noexcept
+{
+    while (updateLine_ < UPDATE_DONE)
+    {
+        // Leave room for the telemetry of this loop
+        const uint8_t lines = updateLine_ == UPDATE_BOOT_STATUS || updateLine_ == UPDATE_RTC ? UPDATE_STEP_LINES : 1;
+        if (TxQueue::Free() <= (lines + 1) * (TX_LINE_LENGTH + 1))
+            return;
+        SendUpdateLine(updateLine_++);
+    }
+}
+
+void VBM::SendUpdateLine(uint8_t Line) noexcept
+{
+    const auto since = updateSince_;
+    if (Line >= static_cast<uint8_t>(Snapshot::Field::Timers) && Line < Snapshot::FIELDS)
+    {
+        // Days of the week, the on and off times in minutes from midnight and ready-by of all timers, 1 based as in
+        // the commands (>timer1dow, >timer2dow, ...)
+        const uint8_t timer = (Line - static_cast<uint8_t>(Snapshot::Field::Timers)) / 4;
+        const uint8_t part = (Line - static_cast<uint8_t>(Snapshot::Field::Timers)) % 4;
+        if (timer >= clock_.NumberOfTimers() || !snapshot_.ChangedSince(Line, since))
+            return;
+        TxLine line;
+        line.AppendP(PSTR(">timer")).Append(static_cast<long>(timer + 1));
+        if (part == 0)
+            line.AppendP(PSTR("dow:")).Append(clock_.Days(timer));
+        else if (part == 1)
+            line.AppendP(PSTR("on:")).Append(clock_.TurnOnAt(timer));
+        else if (part == 2)
+            line.AppendP(PSTR("off:")).Append(clock_.TurnOffAt(timer));
+        else
+            line.AppendP(PSTR("readyby:")).Append(static_cast<long>(clock_.IsReadyBy(timer)));
+        line.Send();
+        return;
+    }
+
+    // The boot status and the RTC readout are only part of the full update
+    if (Line >= Snapshot::FIELDS)
+    {
+        if (Line == UPDATE_BOOT_STATUS && since == 0)
+        {
+            communicator_.Send(PSTR("heatuptime"), static_cast<long>(clock_.HeatUpTime()));
+            SendBootStatus();
+        }
+        else if (Line == UPDATE_RTC && since == 0)
+            SendAdditionalParams();
+        else if (Line == UPDATE_VERSION)
+            communicator_.Send(PSTR("version"), snapshot_.Version());
+        return;
+    }
+
+    if (!snapshot_.ChangedSince(Line, since))
+        return;
+    switch (static_cast<Snapshot::Field>(Line))
+    {
+        // Current machine state (on or off)
+        case Snapshot::Field::TurnedOn:
+            communicator_.Send(PSTR("turnedon"), machine_.State() != State::Off);
+            break;
+        // Time from DS3231 as unix time
+        case Snapshot::Field::UnixTime:
+            communicator_.Send(PSTR("unixtime"), clock_.UnixTime());
+            break;
+        case Snapshot::Field::SetpointBrew:
+            communicator_.Send(PSTR("setpointbrew"), SETPOINT_BREW_TEMP, 2);
+            break;
+        case Snapshot::Field::SetpointSteam:
+            communicator_.Send(PSTR("setpointsteam"), SETPOINT_STEAM_TEMP, 2);
+            break;
+        case Snapshot::Field::SetpointEco:
+            communicator_.Send(PSTR("setpointeco"), SETPOINT_ECO_TEMP, 2);
+            break;
+        case Snapshot::Field::SetpointGroup:
+            communicator_.Send(PSTR("setpointgroup"), SETPOINT_GROUP_TEMP, 2);
+            break;
+        case Snapshot::Field::SleepTimeout:
+            communicator_.Send(PSTR("sleeptimeout"), static_cast<long>(SLEEP_TIMEOUT));
+            break;
+        case Snapshot::Field::PumpProfile:
+            communicator_.Send(PSTR("pumpprofile"), static_cast<long>(pumpProfile_));
+            break;
+        case Snapshot::Field::TargetVolume:
+            communicator_.Send(PSTR("targetvolume"), static_cast<long>(TARGET_VOLUME));
+            break;
+        case Snapshot::Field::PumpPressureLimit:
+            communicator_.Send(PSTR("pressurelimit"), PUMP_PRESSURE_LIMIT, 2);
+            break;
+        case Snapshot::Field::Pressure:
+            communicator_.Send(PSTR("pressure"), PressureSensor::Pressure(), 2);
+            break;
+        case Snapshot::Field::Temperature:
+            communicator_.Send(PSTR("temp"), heater_.CurrentTemperature(), 2);
+            break;
+        case Snapshot::Field::GroupTemperature:
+            if (heater_.HasGroupSensor())
+                communicator_.Send(PSTR("grouptemp"), heater_.GroupTemperature(), 2);
+            break;
+        case Snapshot::Field::GroupEstimate:
+            communicator_.Send(PSTR("groupestimate"), heater_.GroupEstimate(), 2);
+            break;
+        case Snapshot::Field::State:
+            communicator_.Send(PSTR("state"), static_cast<long>(machine_.State()));
+            break;
+        case Snapshot::Field::Readiness:
+            communicator_.Send(PSTR("readiness"), static_cast<long>(heater_.ReadyConfidence()));
+            break;
+        case Snapshot::Field::Eta:
+            communicator_.Send(PSTR("eta"), static_cast<long>(heater_.Eta()));
+            break;
+        default:
+            break;
+    }
+}
+
+void VBM::RefreshSnapshot() noexcept
+{
+    snapshot_.Set(Snapshot::Field::TurnedOn, machine_.State() != State::Off);
+    // Unix time runs on its own, only a jump of the clock is a change
+    snapshot_.Set(Snapshot::Field::UnixTime, clock_.UnixTime() - millis() / 1000, 2);
+    snapshot_.Set(Snapshot::Field::SetpointBrew, lround(SETPOINT_BREW_TEMP * 100));
+    snapshot_.Set(Snapshot::Field::SetpointSteam, lround(SETPOINT_STEAM_TEMP * 100));
+    snapshot_.Set(Snapshot::Field::SetpointEco, lround(SETPOINT_ECO_TEMP * 100));
+    snapshot_.Set(Snapshot::Field::SetpointGroup, lround(SETPOINT_GROUP_TEMP * 100));
+    snapshot_.Set(Snapshot::Field::SleepTimeout, SLEEP_TIMEOUT);
+    snapshot_.Set(Snapshot::Field::PumpProfile, pumpProfile_);
+    snapshot_.Set(Snapshot::Field::TargetVolume, TARGET_VOLUME);
+    snapshot_.Set(Snapshot::Field::PumpPressureLimit, lround(PUMP_PRESSURE_LIMIT * 100));
+    snapshot_.Set(Snapshot::Field::Pressure, lround(PressureSensor::Pressure() * 100), PRESSURE_REPORT_RESOLUTION);
+    snapshot_.Set(Snapshot::Field::Temperature, lround(heater_.CurrentTemperature() * 100),
+                  TEMPERATURE_REPORT_RESOLUTION);
+    snapshot_.Set(Snapshot::Field::GroupTemperature, lround(heater_.GroupTemperature() * 100),
+                  TEMPERATURE_REPORT_RESOLUTION);
+    snapshot_.Set(Snapshot::Field::GroupEstimate, lround(heater_.GroupEstimate() * 100),
+                  TEMPERATURE_REPORT_RESOLUTION);
+    snapshot_.Set(Snapshot::Field::State, static_cast<long>(machine_.State()));
+    // Ready (100) and not in range (0) are always sent
+    const uint8_t confidence = heater_.ReadyConfidence();
+    snapshot_.Set(Snapshot::Field::Readiness, confidence, confidence % 100 ? READINESS_REPORT_RESOLUTION : 0);
+    // Ready (0) is always sent
+    const long eta = heater_.Eta();
+    snapshot_.Set(Snapshot::Field::Eta, eta, eta ? ETA_REPORT_RESOLUTION : 0);
+    for (uint8_t timer = 0; timer < clock_.NumberOfTimers(); ++timer)
+    {
+        snapshot_.Set(Snapshot::TimerField(timer, 0), clock_.Days(timer));
+        snapshot_.Set(Snapshot::TimerField(timer, 1), clock_.TurnOnAt(timer));
+        snapshot_.Set(Snapshot::TimerField(timer, 2), clock_.TurnOffAt(timer));
+        snapshot_.Set(Snapshot::TimerField(timer, 3), clock_.IsReadyBy(timer));
+    }
+}
+
+void VBM::SendAdditionalParams() const noexcept
+{
+    if (!clock_.IsAvailable())
+        return;
+    const auto now = clock_.rtc_.now();
+    communicator_.Send(PSTR("RTCUnix"), now.unixtime());
+    communicator_.Send(PSTR("weekday"), now.dayOfTheWeek());
+    TxLine()
+        .AppendP(PSTR("clock:")).Append(now.year()).AppendP(PSTR("/"))
+        .Append(now.month()).AppendP(PSTR("/")).Append(now.day())
+        .AppendP(PSTR(" - ")).Append(now.hour()).AppendP(PSTR(":"))
+        .Append(now.minute()).AppendP(PSTR(":")).Append(now.second())
+        .Send();
+}
+
+void VBM::SendBootStatus() const noexcept
+{
+    communicator_.Send(PSTR("boottime"), static_cast<long>(bootTime_));
+    communicator_.Send(PSTR("rtc"), clock_.IsAvailable());
+}
+
+void VBM::SendStats() const noexcept
+{
+    TxLine()
+        .AppendP(PSTR(">stats:")).Append(static_cast<long>(energyMeter_.PoweredTime())).AppendP(PSTR(","))
+        .Append(static_cast<long>(energyMeter_.HeaterOnTime())).AppendP(PSTR(","))
+        .Append(static_cast<long>(energyMeter_.PumpOnTime())).AppendP(PSTR(","))
+        .Append(static_cast<long>(energyMeter_.Shots()))
+        .Send();
+    TxLine()
+        .AppendP(PSTR(">energy:")).Append(static_cast<long>(energyMeter_.Energy(EnergyMeter::Usage::HeatUp)))
+        .AppendP(PSTR(",")).Append(static_cast<long>(energyMeter_.Energy(EnergyMeter::Usage::Idle)))
+        .AppendP(PSTR(",")).Append(static_cast<long>(energyMeter_.Energy(EnergyMeter::Usage::Steam)))
+        .AppendP(PSTR(",")).Append(static_cast<long>(energyMeter_.Energy(EnergyMeter::Usage::Sleep)))
+        .Send();
+    for (uint8_t day = 0; day < STATS_DAYS; ++day)
+        TxLine()
+            .AppendP(PSTR(">energyday:")).Append(static_cast<long>(day)).AppendP(PSTR(","))
+            .Append(static_cast<long>(energyMeter_.DayEnergy(day)))
+            .Send();
+    communicator_.Send(PSTR("heaterwattage"), static_cast<long>(HEATER_WATTAGE));
+}
+
+EnergyMeter::Usage VBM::CurrentUsage() const noexcept
+{
+    switch (machine_.State())
+    {
+        case State::Sleep:
+            return EnergyMeter::Usage::Sleep;
+        case State::IdleBrew:
+            return EnergyMeter::Usage::Idle;
+        case State::IdleSteam:
+            return EnergyMeter::Usage::Steam;
+        // Off and error do not heat
+        default:
+            return EnergyMeter::Usage::HeatUp;
+    }
+}
+
+void VBM::SendMemoryStatus() const noexcept
+{
+    communicator_.Send(PSTR("freeheap"), MemoryMonitor::FreeHeap());
+    communicator_.Send(PSTR("largestblock"), MemoryMonitor::LargestFreeBlock());
+    communicator_.Send(PSTR("stackhwm"), MemoryMonitor::StackHighWaterMark());
+    communicator_.Send(PSTR("stringallocs"), MemoryMonitor::StringAllocations());
+}
+
+const char* VBM::StateToString() const noexcept
+{
+    switch (machine_.State())
     {
         case State::Error:
             return "Error";
@@ -98,238 +473,483 @@ void VBM::Update() noexcept
     currentTime_ = millis();
 
     // Update communication input
-    communicator_->Update();
-    HandleCommunication(communicator_->Command());
+    communicator_.Update();
+    HandleCommunication(communicator_.Command());
 
     // Update timer dependent machine state
-    clock_->Update();
-    if (clock_->HasNewState())
+    clock_.Update();
+    if (clock_.HasNewState())
     {
-        if (clock_->State() == Clock::State::Off)
-        {
-            LOG_VBM("VBM Timer turn machine off")
-            machineState_ = State::Off;
-            heater_->SetHeaterTo(Heater::State::Off);
-            communicator_->SendMessageOnce("turnedon", 0);
-        }
-        else if (clock_->State() == Clock::State::On)
-        {
-            LOG_VBM("VBM Timer turn machine on")
-            if (machineState_ == State::Off || machineState_ == State::Sleep)
-            {
-                machineState_ = State::HeatingUpBrew;
-                heater_->SetHeaterTo(Heater::State::BrewTemp);
-                communicator_->SendMessageOnce("turnedon", 1);
-            }
-        }
+        LOG_VBM("VBM Timer turn machine {}", static_cast<int>(clock_.State()))
+        Dispatch(clock_.State() == Clock::State::On ? StateMachine::Event::TimerOn : StateMachine::Event::TimerOff);
     }
 
     // Brew lever state changed
-    HandleBrewLever(buttonBrew_->IsPressed());
+    HandleBrewLever(buttonBrew_.IsPressed());
+    PumpProfile::Update(currentTime_);
+    PressureSensor::Update(currentTime_);
+    PumpProfile::LimitPressure(PressureSensor::Pressure());
+    HandleFlow();
 
     // Update possible button input
-    button_->Update();
-    HandleButton(button_->RegisteredButtonPress());
-    LOG_VBM(String("Got machine state from button: ") + static_cast<int>(machineState_) + " -- " + StateToString())
+    button_.Update();
+    HandleButton(button_.RegisteredButtonPress());
+    LOG_VBM("Got machine state from button: {} -- {}", static_cast<int>(machine_.State()), StateToString())
 
     // Do a calculation on the heater and bring the machine state in relation to the heater state
-    heater_->Update();
-    if (heater_->IsReady())
+    heater_.Update();
+    if (!bootTime_)
     {
-        if (machineState_ == State::CoolingDown || machineState_ == State::HeatingUpBrew)
-            machineState_ = State::IdleBrew;
-        else if (machineState_ == State::HeatingUpSteam)
-            machineState_ = State::IdleSteam;
-        LOG_VBM(String("Heater updated machine state to: ") + static_cast<int>(machineState_))
+        bootTime_ = millis();
+        SendBootStatus();
     }
+    HandleSupervisor();
+    energyMeter_.Update(heater_.Power(), pumpOn_, CurrentUsage(), clock_.UnixTime() / 86400UL, currentTime_);
+    if (heater_.Boost().HasNewReport())
+    {
+        communicator_.Send(PSTR("steamboost"), static_cast<long>(heater_.Boost().LastBoost()));
+        communicator_.Send(PSTR("steamrecovery"), static_cast<long>(heater_.Boost().LastRecovery()));
+    }
+    if (heater_.IsReady())
+        Dispatch(StateMachine::Event::HeaterReady);
+    // Ready-by timers turn on earlier the more the boiler cooled down, and the group needs to soak on top
+    clock_.SetHeatUpTime(heater_.EtaTo(SETPOINT_BREW_TEMP) + READY_BY_SOAK_TIME);
+    // Only changes anything when idle at brew temperature
+    if (SLEEP_TIMEOUT && currentTime_ - lastActivity_ >= SLEEP_TIMEOUT * 60000UL)
+        Dispatch(StateMachine::Event::Inactive);
+    if (currentTime_ - temperatureRecordedAt_ >= FLIGHT_RECORDER_TEMPERATURE_INTERVAL)
+    {
+        temperatureRecordedAt_ = currentTime_;
+        FlightRecorder::Record(FlightRecorder::Kind::Temperature, static_cast<int8_t>(machine_.State()) + 1,
+                               lround(heater_.CurrentTemperature() * 10));
+    }
+
+    SendUpdate();
+    SendBlackBox();
 
-    // Update led state of the machine before led updates the "display"
+    // Update led state of the machine, the led plays it from the ticker interrupt
     HandleLED();
-    led_->Update(currentTime_);
+}
+
+void VBM::Dispatch(StateMachine::Event Event) noexcept
+{
+    const auto from = machine_.State();
+    const auto transition = machine_.Dispatch(Event);
+    if (from != transition.next)
+    {
+        FlightRecorder::Record(FlightRecorder::Kind::Transition,
+                               (static_cast<int8_t>(from) + 1) << 4 | (static_cast<int8_t>(transition.next) + 1),
+                               static_cast<uint8_t>(Event));
+        // The sleep timeout starts over in every state
+        lastActivity_ = currentTime_;
+    }
+    if (transition.actions & StateMachine::HeatOff)
+        heater_.SetHeaterTo(Heater::State::Off);
+    if (transition.actions & StateMachine::HeatBrew)
+        heater_.SetHeaterTo(Heater::State::BrewTemp);
+    if (transition.actions & StateMachine::HeatSteam)
+        heater_.SetHeaterTo(Heater::State::SteamTemp);
+    if (transition.actions & StateMachine::HeatEco)
+        heater_.SetHeaterTo(Heater::State::EcoTemp);
+    if (transition.actions & StateMachine::PumpOff)
+        TurnPumpOff();
+    if (transition.actions & StateMachine::TogglePump)
+        TogglePump();
+    if (transition.actions & StateMachine::ReportOn)
+        communicator_.SendMessageOnce("turnedon", 1);
+    if (transition.actions & StateMachine::ReportOff)
+        communicator_.SendMessageOnce("turnedon", 0);
+
+    // Tell the app how long waking up takes, from the temperature the boiler sagged to while asleep
+    if (from == State::Sleep && transition.next == State::HeatingUpBrew)
+        communicator_.Send(PSTR("wakeeta"), static_cast<long>(heater_.EtaTo(SETPOINT_BREW_TEMP)));
+
+    // Keep the heating rate learned on the way up for the ready-by timers after a power cut, once per heat-up
+    if (from == State::HeatingUpBrew && transition.next == State::IdleBrew)
+        eeprom_.Save(Eeprom::Parameter::HeatingRate, static_cast<float>(heater_.HeatingRate()));
+
+    // Turning off often comes right before switching off at the mains
+    if (transition.next == State::Off && from != State::Off)
+        energyMeter_.Save();
+
+    // Heater and pump are off now, so the blocking eeprom write does no harm
+    if (transition.next == State::Error && from != State::Error)
+        FlightRecorder::Persist(FlightRecorder::Cause::Error);
+}
+
+void VBM::SendStateLog() const noexcept
+{
+    for (uint8_t i = 0; i < machine_.LogCount(); ++i)
+    {
+        const auto& entry = machine_.Log(i);
+        TxLine()
+            .AppendP(PSTR(">statelog:")).Append(entry.at).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.event)).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.from)).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.to))
+            .Send();
+    }
+}
+
+void VBM::SendBlackBox(bool Start) noexcept
+{
+    const auto count = FlightRecorder::SavedCount();
+    if (Start)
+    {
+        blackBoxLine_ = 0;
+        TxLine()
+            .AppendP(PSTR(">blackbox:")).Append(static_cast<long>(FlightRecorder::SavedCause())).AppendP(PSTR(","))
+            .Append(static_cast<long>(FlightRecorder::SavedResetFlags())).AppendP(PSTR(","))
+            .Append(static_cast<long>(count))
+            .Send();
+    }
+
+    // Leave room for the telemetry of this loop
+    while (blackBoxLine_ < count && TxQueue::Free() > 2 * (TX_LINE_LENGTH + 1))
+    {
+        const auto entry = FlightRecorder::SavedEntry(blackBoxLine_++);
+        TxLine()
+            .AppendP(PSTR(">blackboxentry:")).Append(static_cast<long>(entry.at)).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.kind)).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.data)).AppendP(PSTR(","))
+            .Append(static_cast<long>(entry.value))
+            .Send();
+    }
+}
+
+void VBM::HandleSupervisor() noexcept
+{
+    const auto fault = Supervisor::Tripped();
+    if (fault == Supervisor::Fault::None)
+        return;
+
+    if (!faultReported_)
+    {
+        faultReported_ = true;
+        LOG_VBM("Supervisor tripped: {}", static_cast<uint8_t>(fault))
+        FlightRecorder::Record(FlightRecorder::Kind::Fault, static_cast<uint8_t>(fault),
+                               lround(heater_.CurrentTemperature() * 10));
+        communicator_.Send(PSTR("fault"), static_cast<long>(fault));
+    }
+    Dispatch(StateMachine::Event::Fault);
+}
+
+void VBM::SendSupervisorStatus() const noexcept
+{
+    communicator_.Send(PSTR("fault"), static_cast<long>(Supervisor::Tripped()));
+    communicator_.Send(PSTR("reactionlatency"), static_cast<long>(Supervisor::WorstReactionLatency()));
+}
+
+void VBM::HandleActivity() noexcept
+{
+    lastActivity_ = currentTime_;
+    Dispatch(StateMachine::Event::Activity);
 }
 
 void VBM::HandleButton(Button::Command ButtonCommand) noexcept
 {
+    if (ButtonCommand != Button::Command::Nothing)
+        FlightRecorder::Record(FlightRecorder::Kind::Button, static_cast<uint8_t>(ButtonCommand));
+
     switch (ButtonCommand)
     {
         case Button::Command::Nothing:
             // This does nothing for us
             break;
-        case Button::Command::Click: {
-            if (machineState_ == State::Off || machineState_ == State::Sleep)
-            {
-                heater_->SetHeaterTo(Heater::State::BrewTemp);
-                machineState_ = State::HeatingUpBrew;
-                communicator_->SendMessageOnce("turnedon", 1);
-            }
-            else
-                TogglePump();
-        }
-        break;
-        case Button::Command::ShortPress: {
-            if (machineState_ == State::Off)
-            {
-                heater_->SetHeaterTo(Heater::State::BrewTemp);
-                machineState_ = State::HeatingUpBrew;
-            }
-            else if (machineState_ == State::HeatingUpSteam || machineState_ == State::IdleSteam)
-            {
-                heater_->SetHeaterTo(Heater::State::BrewTemp);
-                machineState_ = heater_->IsReady() ? State::IdleBrew : State::CoolingDown;
-            }
-            else if (machineState_ == State::HeatingUpBrew || machineState_ == State::IdleBrew ||
-                     machineState_ == State::CoolingDown)
-            {
-                heater_->SetHeaterTo(Heater::State::SteamTemp);
-                machineState_ = heater_->IsReady() ? State::IdleSteam : State::HeatingUpSteam;
-            }
-            else
-            {
-                LOG_VBM(String("Unkown machine state from button: ") + static_cast<int>(ButtonCommand) +
-                        " with current state: " + static_cast<int>(machineState_))
-                heater_->SetHeaterTo(Heater::State::Off);
-                machineState_ = State::Error;
-            }
-        }
-        break;
-        case Button::Command::LongPress: {
-            heater_->SetHeaterTo(Heater::State::Off);
-            TurnPumpOff();
-            machineState_ = State::Off;
-            communicator_->SendMessageOnce("turnedon", 0);
-        }
-        break;
+        case Button::Command::Click:
+            Dispatch(StateMachine::Event::Click);
+            break;
+        case Button::Command::ShortPress:
+            Dispatch(StateMachine::Event::ShortPress);
+            break;
+        case Button::Command::LongPress:
+            Dispatch(StateMachine::Event::LongPress);
+            break;
 
         case Button::Command::Error:
-        default: {
-            heater_->SetHeaterTo(Heater::State::Off);
-            machineState_ = State::Error;
-        }
-        break;
+        default:
+            Dispatch(StateMachine::Event::ButtonError);
+            break;
     }
+    if (ButtonCommand != Button::Command::Nothing)
+        HandleActivity();
 }
 
 void VBM::HandleBrewLever(bool IsBrewing) noexcept
 {
-    if (machineState_ != State::Off && wasBrewing_ != IsBrewing)
+    if (machine_.State() != State::Off && wasBrewing_ != IsBrewing)
     {
-        if (!DISABLE_PUMP)
-            IsBrewing ? digitalWrite(PUMP_SSR_PIN, HIGH) : digitalWrite(PUMP_SSR_PIN, LOW);
+        // The lever runs the pump through the selected profile, which is plain on without one
+        if (!DISABLE_PUMP && IsBrewing)
+            PumpProfile::Start(currentTime_);
+        else
+            PumpProfile::Stop();
+        // A shot is measured from lever down to lever up
+        if (IsBrewing)
+            FlowMeter::Reset();
+        SendShot();
         pumpOn_ = IsBrewing;
         wasBrewing_ = IsBrewing;
+        heater_.SetBrewing(IsBrewing);
+        energyMeter_.SetBrewing(IsBrewing, currentTime_);
 
         // Also let the App know if we brew or not for timers and such
-        communicator_->SendMessageOnce("isbrewing", IsBrewing);
+        communicator_.SendMessageOnce("isbrewing", IsBrewing);
+        HandleActivity();
     }
 }
 
+void VBM::HandleFlow() noexcept
+{
+    FlowMeter::Update(currentTime_);
+    if (!wasBrewing_)
+        return;
+    // The lever stays down, the pump goes off. Only the shot's own pumping is stopped, not a click on the button
+    if (TARGET_VOLUME && PumpProfile::IsRunning() && FlowMeter::Volume() >= TARGET_VOLUME)
+    {
+        LOG_VBM("Target volume reached: {} ml", FlowMeter::Volume())
+        PumpProfile::Stop();
+        pumpOn_ = false;
+        SendShot();
+    }
+    if (currentTime_ - flowReportedAt_ >= FLOW_REPORT_INTERVAL)
+        SendShot();
+}
+
+void VBM::SendShot() noexcept
+{
+    flowReportedAt_ = currentTime_;
+    communicator_.Send(PSTR("volume"), FlowMeter::Volume(), 1);
+    communicator_.Send(PSTR("flow"), FlowMeter::Flow(), 2);
+    if (PressureSensor::IsPresent())
+        communicator_.Send(PSTR("pressure"), PressureSensor::Pressure(), 2);
+}
+
 void VBM::HandleLED() noexcept
 {
-    switch (machineState_)
+    switch (machine_.State())
     {
         case State::Off:
-            led_->ShowStatus(LED::Signal::Off);
+            led_.ShowStatus(LED::Signal::Off);
             break;
         case State::Sleep:
-            led_->ShowStatus(LED::Signal::Half);
+            led_.ShowStatus(LED::Signal::Half);
+            break;
         case State::HeatingUpBrew:
-            led_->ShowStatus(LED::Signal::Quarter);
+            led_.ShowStatus(LED::Signal::Quarter);
             break;
         case State::IdleBrew:
-            led_->ShowStatus(LED::Signal::Whole);
+            led_.ShowStatus(LED::Signal::Whole);
             break;
         case State::HeatingUpSteam:
-            led_->ShowStatus(LED::Signal::Sixteenth);
+            led_.ShowStatus(LED::Signal::Sixteenth);
             break;
         case State::IdleSteam:
-            led_->ShowStatus(LED::Signal::Eights);
+            led_.ShowStatus(LED::Signal::Eights);
             break;
         case State::CoolingDown:
-            led_->ShowStatus(LED::Signal::Trab);
+            led_.ShowStatus(LED::Signal::Trab);
             break;
 
         default:
         case State::Error:
-            led_->ShowStatus(LED::Signal::Gallop);
-            break;
+            led_.Show(LED::Priority::Error, LED::Signal::Gallop);
+            return;
     }
+    led_.Clear(LED::Priority::Error);
 }
 
 void VBM::HandleCommunication(enum Communicator::Command Command) noexcept
 {
+    if (Command != Communicator::Command::None)
+        FlightRecorder::Record(FlightRecorder::Kind::Command, static_cast<uint8_t>(Command));
+
     switch (Command)
     {
         case Communicator::Command::TurnOn: {
-            LOG_VBM(String("communication: TurnOn"))
-            heater_->SetHeaterTo(Heater::State::BrewTemp);
-            machineState_ = State::HeatingUpBrew;
+            LOG_VBM("communication: TurnOn")
+            Dispatch(StateMachine::Event::AppTurnOn);
         }
         break;
         case Communicator::Command::TurnOff: {
-            LOG_VBM(String("communication: TurnOff"))
-            heater_->SetHeaterTo(Heater::State::Off);
-            machineState_ = State::Off;
+            LOG_VBM("communication: TurnOff")
+            Dispatch(StateMachine::Event::AppTurnOff);
         }
         break;
         case Communicator::Command::UpdateSetpointBrew: {
             float newSetpointBrew = 0;
-            communicator_->Value(newSetpointBrew);
-            LOG_VBM(String("communication: UpdateSetpointBrew:") + newSetpointBrew)
+            communicator_.Value(newSetpointBrew);
+            LOG_VBM("communication: UpdateSetpointBrew:{}", newSetpointBrew)
+            // The supervisor trips a margin above MAX_SETPOINT
+            if (newSetpointBrew > MAX_SETPOINT)
+                break;
             SETPOINT_BREW_TEMP = newSetpointBrew;
             // Save the new setpoint to the eeprom, cast to be excactly clear what type we want!
-            eeprom_->Save(Eeprom::Parameter::SetpointBrew, static_cast<float>(newSetpointBrew));
+            eeprom_.Save(Eeprom::Parameter::SetpointBrew, static_cast<float>(newSetpointBrew));
         }
         break;
         case Communicator::Command::UpdateSetpointSteam: {
             float newSetpointSteam = 0;
-            communicator_->Value(newSetpointSteam);
-            LOG_VBM(String("communication: UpdateSetpointSteam:") + newSetpointSteam)
+            communicator_.Value(newSetpointSteam);
+            LOG_VBM("communication: UpdateSetpointSteam:{}", newSetpointSteam)
+            // The supervisor trips a margin above MAX_SETPOINT
+            if (newSetpointSteam > MAX_SETPOINT)
+                break;
             SETPOINT_STEAM_TEMP = newSetpointSteam;
             // Save the new setpoint to the eeprom, cast to be excactly clear what type we want!
-            eeprom_->Save(Eeprom::Parameter::SetpointSteam, static_cast<float>(newSetpointSteam));
+            eeprom_.Save(Eeprom::Parameter::SetpointSteam, static_cast<float>(newSetpointSteam));
+        }
+        break;
+        case Communicator::Command::UpdateSetpointEco: {
+            float newSetpointEco = 0;
+            communicator_.Value(newSetpointEco);
+            LOG_VBM("communication: UpdateSetpointEco:{}", newSetpointEco)
+            // The supervisor trips a margin above MAX_SETPOINT
+            if (newSetpointEco > MAX_SETPOINT)
+                break;
+            SETPOINT_ECO_TEMP = newSetpointEco;
+            eeprom_.Save(Eeprom::Parameter::SetpointEco, static_cast<float>(newSetpointEco));
+        }
+        break;
+        case Communicator::Command::UpdateSetpointGroup: {
+            float newSetpointGroup = 0;
+            communicator_.Value(newSetpointGroup);
+            LOG_VBM("communication: UpdateSetpointGroup:{}", newSetpointGroup)
+            // 0 turns the group control off, NaN fails both comparisons
+            if (!(newSetpointGroup >= 0 && newSetpointGroup <= MAX_SETPOINT))
+                break;
+            SETPOINT_GROUP_TEMP = newSetpointGroup;
+            eeprom_.Save(Eeprom::Parameter::SetpointGroup, static_cast<float>(newSetpointGroup));
+        }
+        break;
+        case Communicator::Command::SleepTimeout: {
+            uint16_t timeoutInMin = 0;
+            communicator_.Value(timeoutInMin);
+            LOG_VBM("communication: Sleep after {} min", timeoutInMin)
+            SLEEP_TIMEOUT = timeoutInMin;
+            eeprom_.Save(Eeprom::Parameter::SleepTimeout, timeoutInMin);
+        }
+        break;
+        case Communicator::Command::HeaterWattage: {
+            uint16_t wattage = 0;
+            communicator_.Value(wattage);
+            LOG_VBM("communication: HeaterWattage:{}", wattage)
+            HEATER_WATTAGE = wattage;
+            eeprom_.Save(Eeprom::Parameter::HeaterWattage, wattage);
+        }
+        break;
+        case Communicator::Command::TargetVolume: {
+            uint16_t volume = 0;
+            communicator_.Value(volume);
+            LOG_VBM("communication: TargetVolume:{}", volume)
+            TARGET_VOLUME = volume;
+            eeprom_.Save(Eeprom::Parameter::TargetVolume, volume);
+        }
+        break;
+        case Communicator::Command::PumpPressureLimit: {
+            float limit = 0;
+            communicator_.Value(limit);
+            LOG_VBM("communication: PumpPressureLimit:{}", limit)
+            // 0 holds no limit, the sensor cannot read above its full scale
+            if (!(limit >= 0 && limit <= PRESSURE_SENSOR_MAX))
+                break;
+            PUMP_PRESSURE_LIMIT = limit;
+            eeprom_.Save(Eeprom::Parameter::PumpPressureLimit, limit);
+        }
+        break;
+        case Communicator::Command::PumpProfile: {
+            communicator_.Value(pumpProfile_);
+            LOG_VBM("communication: PumpProfile:{}", pumpProfile_)
+            LoadPumpProfile();
+            eeprom_.Save(Eeprom::Parameter::PumpProfile, pumpProfile_);
+        }
+        break;
+        case Communicator::Command::SegmentDuty:
+        case Communicator::Command::SegmentTime: {
+            uint8_t value = 0;
+            communicator_.Value(value);
+            LOG_VBM("communication: Profile {} segment {}: {}", communicator_.Profile() + 1,
+                    communicator_.Segment() + 1, value)
+            if (communicator_.Profile() >= PUMP_PROFILES || communicator_.Segment() >= PUMP_PROFILE_SEGMENTS)
+                break;
+            const unsigned int index = communicator_.Profile() * PUMP_PROFILE_SEGMENTS + communicator_.Segment();
+            auto segment = LoadSegment(index);
+            if (Command == Communicator::Command::SegmentDuty)
+                segment.duty = value < 100 ? value : 100;
+            else
+                segment.time = value;
+            if (SaveSegment(index, segment))
+                LoadPumpProfile();
+        }
+        break;
+        case Communicator::Command::PumpProfiles: {
+            LOG_VBM("communication: PumpProfiles")
+            SendPumpProfiles();
         }
         break;
         case Communicator::Command::DurationTimer: {
             unsigned long int durationInMin = 0;
-            communicator_->Value(durationInMin);
-            LOG_VBM(String("communication: Turn machine off in ") + durationInMin * 60 + " s")
-            clock_->SetTurnOffIn(durationInMin * 60);
+            communicator_.Value(durationInMin);
+            LOG_VBM("communication: Turn machine off in {} s", durationInMin * 60)
+            clock_.SetTurnOffIn(durationInMin * 60);
+        }
+        break;
+        case Communicator::Command::DaysTimer: {
+            const auto timer = communicator_.Timer();
+            if (timer >= clock_.NumberOfTimers())
+                break;
+            uint8_t days = 0;
+            communicator_.Value(days);
+            LOG_VBM("communication: Set days of timer {} to {}", timer + 1, days)
+            clock_.SetDays(days, timer);
+            eeprom_.Save(Eeprom::Parameter::TimerDays, timer, days);
         }
         break;
-        case Communicator::Command::DaysTimer1: {
-            uint8_t daysTimer1 = 0;
-            communicator_->Value(daysTimer1);
-            LOG_VBM(String("communication: Set days to ") + daysTimer1)
-            clock_->SetDays(daysTimer1);
-            eeprom_->Save(Eeprom::Parameter::Timer1Days, daysTimer1);
+        case Communicator::Command::TimerOn: {
+            const auto timer = communicator_.Timer();
+            // The clock's getters do not check the timer
+            if (timer >= clock_.NumberOfTimers())
+                break;
+            uint16_t timeFromMidnightInMinOn = 0;
+            communicator_.Value(timeFromMidnightInMinOn);
+            LOG_VBM("communication: Timer {} turns machine on at {}:{}", timer + 1, timeFromMidnightInMinOn / 60,
+                    timeFromMidnightInMinOn % 60)
+            clock_.SetTurnOnAt(timeFromMidnightInMinOn, timer);
+            eeprom_.Save(Eeprom::Parameter::TimerTurnOn, timer, static_cast<uint16_t>(clock_.TurnOnAt(timer)));
+            eeprom_.Save(Eeprom::Parameter::TimerReadyBy, timer, static_cast<uint8_t>(0));
         }
         break;
-        case Communicator::Command::Timer1On: {
-            unsigned long int timeFromMidnightInMinOn = 0;
-            communicator_->Value(timeFromMidnightInMinOn);
-            LOG_VBM(String("communication: Turn machine on at ") +
-                    static_cast<int>((timeFromMidnightInMinOn - static_cast<int>(timeFromMidnightInMinOn) % 60) / 60) +
-                    ":" + static_cast<int>(timeFromMidnightInMinOn) % 60)
-            clock_->SetTurnOnAt(timeFromMidnightInMinOn);
-            eeprom_->Save(Eeprom::Parameter::Timer1TurnOn, timeFromMidnightInMinOn);
+        case Communicator::Command::TimerOff: {
+            const auto timer = communicator_.Timer();
+            // The clock's getters do not check the timer
+            if (timer >= clock_.NumberOfTimers())
+                break;
+            uint16_t timeFromMidnightInMinOff = 0;
+            communicator_.Value(timeFromMidnightInMinOff);
+            LOG_VBM("communication: Timer {} turns machine off at {}:{}", timer + 1, timeFromMidnightInMinOff / 60,
+                    timeFromMidnightInMinOff % 60)
+            clock_.SetTurnOffAt(timeFromMidnightInMinOff, timer);
+            eeprom_.Save(Eeprom::Parameter::TimerTurnOff, timer, static_cast<uint16_t>(clock_.TurnOffAt(timer)));
         }
         break;
-        case Communicator::Command::Timer1Off: {
-            unsigned long int timeFromMidnightInMinOff = 0;
-            communicator_->Value(timeFromMidnightInMinOff);
-            LOG_VBM(
-                String("communication: Turn machine off at ") +
-                static_cast<int>((timeFromMidnightInMinOff - static_cast<int>(timeFromMidnightInMinOff) % 60) / 60) +
-                ":" + static_cast<int>(timeFromMidnightInMinOff) % 60)
-            clock_->SetTurnOffAt(timeFromMidnightInMinOff);
-            eeprom_->Save(Eeprom::Parameter::Timer1TurnOff, timeFromMidnightInMinOff);
+        case Communicator::Command::TimerReadyBy: {
+            const auto timer = communicator_.Timer();
+            if (timer >= clock_.NumberOfTimers())
+                break;
+            uint16_t readyByMin = 0;
+            communicator_.Value(readyByMin);
+            LOG_VBM("communication: Timer {} has the machine ready by {}:{}", timer + 1, readyByMin / 60,
+                    readyByMin % 60)
+            clock_.SetReadyBy(readyByMin, timer);
+            eeprom_.Save(Eeprom::Parameter::TimerTurnOn, timer, static_cast<uint16_t>(clock_.TurnOnAt(timer)));
+            eeprom_.Save(Eeprom::Parameter::TimerReadyBy, timer, static_cast<uint8_t>(clock_.IsReadyBy(timer)));
         }
         break;
         case Communicator::Command::SetUnixTime: {
             unsigned long int appUnixTime = 0;
-            communicator_->Value(appUnixTime);
-            LOG_VBM(String("communication: Got App unix time to update DS3231: ") + appUnixTime)
-            clock_->SetTimeFromUnixTime(appUnixTime);
+            communicator_.Value(appUnixTime);
+            LOG_VBM("communication: Got App unix time to update DS3231: {}", appUnixTime)
+            clock_.SetTimeFromUnixTime(appUnixTime);
         }
         break;
         case Communicator::Command::UpdateApp: {
@@ -337,26 +957,79 @@ void VBM::HandleCommunication(enum Communicator::Command Command) noexcept
             UpdateApp();
         }
         break;
+        case Communicator::Command::UpdateAppSince: {
+            unsigned int since = 0;
+            communicator_.Value(since);
+            LOG_VBM("communication: UpdateApp since {}", since)
+            UpdateApp(since);
+        }
+        break;
+        case Communicator::Command::StateLog: {
+            LOG_VBM("communication: StateLog")
+            SendStateLog();
+        }
+        break;
+        case Communicator::Command::BlackBox: {
+            LOG_VBM("communication: BlackBox")
+            SendBlackBox(true);
+        }
+        break;
+        case Communicator::Command::Supervisor: {
+            LOG_VBM("communication: Supervisor")
+            SendSupervisorStatus();
+        }
+        break;
+        case Communicator::Command::Memory: {
+            LOG_VBM("communication: Memory")
+            SendMemoryStatus();
+        }
+        break;
+        case Communicator::Command::Stats: {
+            LOG_VBM("communication: Stats")
+            SendStats();
+        }
+        break;
         default: {
             // Don't call the log heler as it would break the loop
             // Serial.println(String("HandleCommunication - not implemented command: ") + static_cast<int>(Command));
         }
         break;
     }
+
+    // The app polls for updates and diagnostics, only commands that change something are input
+    switch (Command)
+    {
+        case Communicator::Command::None:
+        case Communicator::Command::UpdateApp:
+        case Communicator::Command::UpdateAppSince:
+        case Communicator::Command::Memory:
+        case Communicator::Command::StateLog:
+        case Communicator::Command::BlackBox:
+        case Communicator::Command::Supervisor:
+        case Communicator::Command::Stats:
+        case Communicator::Command::PumpProfiles:
+            break;
+        default:
+            HandleActivity();
+            break;
+    }
 }
 
 void VBM::TogglePump() noexcept
 {
+    // A click while brewing stops a running profile as well
+    PumpProfile::Stop();
     pumpOn_ = !pumpOn_;
     if (!DISABLE_PUMP)
-        digitalWrite(PUMP_SSR_PIN, pumpOn_);
-    LOG_VBM(String("Pump toggled: ") + pumpOn_)
+        PumpSsrPin::Write(pumpOn_);
+    LOG_VBM("Pump toggled: {}", pumpOn_)
 }
 
 void VBM::TurnPumpOff() noexcept
 {
+    PumpProfile::Stop();
     pumpOn_ = false;
     if (!DISABLE_PUMP)
-        digitalWrite(PUMP_SSR_PIN, pumpOn_);
-    LOG_VBM("Pump turned off");
+        PumpSsrPin::Write(pumpOn_);
+    LOG_VBM("Pump turned off")
 }
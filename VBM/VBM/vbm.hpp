@@ -6,75 +6,103 @@
 #include "clock.hpp"
 #include "communicator.hpp"
 #include "eepromMemory.hpp"
+#include "energyMeter.hpp"
+#include "flightRecorder.hpp"
+#include "flowMeter.hpp"
 #include "heater.hpp"
 #include "led.hpp"
-
-// TODO: This class could be created with the pins used
-// Handles the machine states and the pump, combines heater, led and button
+#include "memoryMonitor.hpp"
+#include "pins.hpp"
+#include "pressureSensor.hpp"
+#include "pumpProfile.hpp"
+#include "snapshot.hpp"
+#include "stateMachine.hpp"
+#include "supervisor.hpp"
+
+// Handles the machine states and the pump, combines heater, led and button.
+// The pins used are bound at compile time, see pins.hpp.
 class VBM
 {
   public:
-    enum class State
-    {
-        Error = -1,
-        Off = 0,
-        Sleep,
-        HeatingUpBrew,
-        IdleBrew,
-        HeatingUpSteam,
-        IdleSteam,
-        CoolingDown
-    };
+    typedef enum StateMachine::State State;
 
     VBM();
 
-    ~VBM();
-
     // Updates the espressomachine's state and hanles the machine's functions
     void Update() noexcept;
 
   private:
-    // Send all needed parameters for display purpose and time sync to the App host time.
-    // Make sure this is called after possible eeprom load of the parameters.
-    void UpdateApp() const noexcept
-    {
-        // Current machine state (on or off)
-        Serial.println(String(">turnedon:") + static_cast<int>(machineState_ != State::Off));
-
-        // Time from DS3231 as unix time
-        const auto unixTime = clock_->UnixTime();
-        Serial.println(String(">unixtime:") + unixTime);
-
-        // Days of the week from all timers
-        const auto timer1DoW = clock_->Days();
-        Serial.println(String(">timer1dow:") + timer1DoW);
-
-        // Timer values to turn the machine on
-        const auto timer1On = clock_->TurnOnAt();
-        Serial.println(String(">timer1on:") + timer1On);
-
-        // Timer values to turn the machine off
-        const auto timer1Off = clock_->TurnOffAt();
-        Serial.println(String(">timer1off:") + timer1Off);
-
-        Serial.println(String(">setpointbrew:") + SETPOINT_BREW_TEMP);
-        Serial.println(String(">setpointsteam:") + SETPOINT_STEAM_TEMP);
-    
-        SendAdditionalParams();    
-    }
-
-    void SendAdditionalParams() const noexcept
-    {
-      const auto now = clock_->rtc_->now();
-      Serial.println(String(">RTCUnix:") + now.unixtime());
-      Serial.println(String(">weekday:") + now.dayOfTheWeek());
-      Serial.println(String("clock:") + now.year() + "/" +  now.month() + "/" + now.day() + " - " + now.hour() + ":" + now.minute() + ":" + now.second());
-      Serial.println(String(">temp:") + heater_->CurrentTemperature());
-      // Serial.println(String(""));
-    }
+    // Send all needed parameters for display purpose and time sync to the App host time, or with Since only the
+    // ones that changed after that snapshot version. Ends with the current version (>version:).
+    // Make sure this is called after possible eeprom load of the parameters. Starts the update, see SendUpdate.
+    void UpdateApp(unsigned int Since = 0) noexcept;
+
+    // Send the started app update a few lines per loop so the TxQueue does not overflow and drop its own lines
+    void SendUpdate() noexcept;
+
+    // Send line Line of the app update: one per snapshot field if it changed, then the boot status, the RTC
+    // readout and the version
+    void SendUpdateLine(uint8_t Line) noexcept;
+
+    // Compare the reported values with the current ones and version the changes
+    void RefreshSnapshot() noexcept;
+
+    void SendAdditionalParams() const noexcept;
+
+    // Older versions stored a single timer in Timer1*, move it to the compact timer storage once
+    void MigrateSingleTimer() noexcept;
+
+    // Send the time from reset to the first PID cycle and whether the RTC is there (>boottime:<ms>, >rtc:<0/1>)
+    void SendBootStatus() const noexcept;
+
+    // Send the energy meter (>stats:<powered s>,<heater on s>,<pump on s>,<shots>,
+    // >energy:<heat-up Wh>,<idle Wh>,<steam Wh>,<sleep Wh>, then >energyday:<days ago>,<Wh> from today on)
+    void SendStats() const noexcept;
+
+    // What the heater energy of the current state counts as
+    EnergyMeter::Usage CurrentUsage() const noexcept;
+
+    // Send heap and stack usage
+    void SendMemoryStatus() const noexcept;
 
     // Helper for debug state
-    String StateToString() const noexcept;
+    const char* StateToString() const noexcept;
+
+    // Feeds an event to the state machine and carries out the actions of the transition
+    void Dispatch(StateMachine::Event Event) noexcept;
+
+    // Send the logged state transitions, oldest first (>statelog:<millis>,<event>,<from>,<to>)
+    void SendStateLog() const noexcept;
+
+    // Send the saved flight recorder a few lines per loop so the TxQueue does not overflow, call with Start to
+    // begin (>blackbox:<cause>,<reset flags>,<count>, then >blackboxentry:<s>,<kind>,<data>,<value> oldest first)
+    void SendBlackBox(bool Start = false) noexcept;
+
+    // Latches the machine in error once the supervisor tripped and reports the fault once
+    void HandleSupervisor() noexcept;
+
+    // Send the supervisor fault and the worst case reaction latency (>fault:<fault>, >reactionlatency:<us>)
+    void SendSupervisorStatus() const noexcept;
+
+    // Notes an input for the sleep timeout and wakes the machine up (Event::Activity)
+    void HandleActivity() noexcept;
+
+    // Hands the segments of the selected pump profile from eeprom to the PumpProfile, none for profile 0
+    void LoadPumpProfile() noexcept;
+
+    // Reads and writes a segment of a pump profile, Index counts over all profiles. Erased eeprom reads as no segment
+    PumpProfile::Segment LoadSegment(uint8_t Index) const noexcept;
+    bool SaveSegment(uint8_t Index, const PumpProfile::Segment& Segment) noexcept;
+
+    // Send the segments of every pump profile (>profile<N>:<duty>,<time>,<duty>,<time>,...)
+    void SendPumpProfiles() const noexcept;
+
+    // Measures the flow, reports it while brewing and stops the pump at TARGET_VOLUME
+    void HandleFlow() noexcept;
+
+    // Send the volume of the current shot, the flow and with a sensor the pressure
+    // (>volume:<ml>, >flow:<ml/s>, >pressure:<bar>)
+    void SendShot() noexcept;
 
     // Manages button presses
     void HandleButton(Button::Command ButtonCommand) noexcept;
@@ -94,19 +122,33 @@ class VBM
     // Turn pump off and set members correctly
     void TurnPumpOff() noexcept;
 
-    Heater* heater_;
-    LED* led_;
-    Button* button_;
-    ButtonBrew* buttonBrew_;
-    Communicator* communicator_;
-    Eeprom* eeprom_;
-    Clock* clock_;
+    // Held by value so the whole machine lives in static storage and its size is known at link time.
+    // Construction follows this order: the communicator opens the serial port before the clock reports to it.
+    Heater heater_;
+    LED led_;
+    Button button_;
+    ButtonBrew buttonBrew_;
+    Communicator communicator_;
+    Eeprom eeprom_;
+    Clock clock_;
+
+    Snapshot snapshot_;
+    EnergyMeter energyMeter_;
 
-    State machineState_;
+    StateMachine machine_;
     unsigned long currentTime_;
+    unsigned long bootTime_;  // millis() at the end of the first PID cycle, 0 before
+    unsigned long temperatureRecordedAt_;
+    unsigned long lastActivity_;  // millis() of the last input or state change, see SLEEP_TIMEOUT
+    unsigned long flowReportedAt_;
+    unsigned int updateSince_;  // version the client of the running app update has
+    uint8_t updateLine_;        // next line of the app update to send, past the last one when done
+    uint8_t blackBoxLine_;  // next saved flight recorder entry to send, FLIGHT_RECORDER_SIZE when done
 
     bool pumpOn_;
     bool wasBrewing_;
+    bool faultReported_;
+    uint8_t pumpProfile_;  // selected pump profile, 1 based, 0 for none
 };
 
 #endif
@@ -0,0 +1,29 @@
+#include "allocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+unsigned long allocations = 0;
+}  // namespace
+
+unsigned long AllocationCounter::Count() noexcept { return allocations; }
+
+void* operator new(std::size_t Size)
+{
+    ++allocations;
+    if (void* memory = std::malloc(Size ? Size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t Size) { return operator new(Size); }
+
+void operator delete(void* Memory) noexcept { std::free(Memory); }
+
+void operator delete[](void* Memory) noexcept { std::free(Memory); }
+
+void operator delete(void* Memory, std::size_t) noexcept { std::free(Memory); }
+
+void operator delete[](void* Memory, std::size_t) noexcept { std::free(Memory); }
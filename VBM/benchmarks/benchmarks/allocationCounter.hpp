@@ -0,0 +1,26 @@
+#ifndef __ALLOCATION_COUNTER_HPP
+#define __ALLOCATION_COUNTER_HPP
+
+#include <iomanip>
+#include <iostream>
+
+// Counts every operator new on host. The host String allocates exactly like the Arduino WString, so the count
+// equals the number of heap blocks the firmware would request on the target.
+namespace AllocationCounter
+{
+unsigned long Count() noexcept;
+
+// Runs Function Iterations times and prints the average number of allocations per call.
+template <class F>
+void Report(const char* Name, F Function, unsigned long Iterations = 1000)
+{
+    const auto before = Count();
+    for (unsigned long i = 0; i < Iterations; ++i)
+        Function();
+    const auto allocations = Count() - before;
+    std::cout << std::left << std::setw(40) << Name << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+              << static_cast<double>(allocations) / Iterations << " allocations/op" << std::endl;
+}
+}  // namespace AllocationCounter
+
+#endif
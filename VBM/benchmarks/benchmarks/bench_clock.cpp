@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "clock.hpp"
+
+namespace
+{
+// Monday 2022-10-17 00:00:00
+constexpr const unsigned long WEEK_START = 1665964800UL;
+constexpr const unsigned long MINUTES_PER_WEEK = 7UL * 24UL * 60UL;
+}  // namespace
+
+TEST_CASE("Clock::Update across a simulated week", "[benchmark][clock]")
+{
+    Clock clock;
+    REQUIRE(clock.Begin());
+    clock.SetTimeFromUnixTime(WEEK_START);
+    clock.SetDays(0x3E);  // Mon - Fri
+    clock.SetTurnOnAt(7 * 60 + 30);
+    clock.SetTurnOffAt(9 * 60);
+
+    // Every call advances the simulated time by one minute and wraps around after a week
+    unsigned long minute = 0;
+    const auto update = [&] {
+        if (++minute == MINUTES_PER_WEEK)
+        {
+            minute = 0;
+            clock.SetTimeFromUnixTime(WEEK_START);
+        }
+        Host::AdvanceMillis(60000UL);
+        clock.Update();
+        return clock.HasNewState();
+    };
+
+    unsigned int transitions = 0;
+    for (unsigned long i = 0; i < MINUTES_PER_WEEK; ++i)
+        transitions += update();
+    REQUIRE(transitions == 10);  // on and off on five days
+
+    AllocationCounter::Report("Clock::Update", update, MINUTES_PER_WEEK);
+    BENCHMARK("Clock::Update") { return update(); };
+}
+
+TEST_CASE("Clock without DS3231 runs without timers", "[benchmark][clock]")
+{
+    Host::rtcPresent = false;
+    Clock clock;
+    REQUIRE_FALSE(clock.Begin());
+    clock.SetTimeFromUnixTime(WEEK_START);
+    clock.SetDays(0x7F);
+    clock.SetTurnOnAt(1);
+    clock.SetTurnOffAt(2);
+    clock.SetTurnOffIn(90);
+
+    // The duration timer still works, the weekday timer never switches
+    unsigned int transitions = 0;
+    for (unsigned long minute = 0; minute < 24 * 60; ++minute)
+    {
+        Host::AdvanceMillis(60000UL);
+        clock.Update();
+        transitions += clock.HasNewState();
+    }
+    REQUIRE(transitions == 1);
+    REQUIRE(clock.State() == Clock::State::Off);
+    // Kept with millis() alone, without losing the fractions of a second on every synchronization
+    REQUIRE(clock.UnixTime() == WEEK_START + 24UL * 60UL * 60UL);
+
+    // The DS3231 is found again on a later synchronization
+    Host::rtcPresent = true;
+    Host::AdvanceMillis(CLOCK_SYNC_INTERVAL);
+    clock.Update();
+    REQUIRE(clock.IsAvailable());
+}
+
+TEST_CASE("Clock ready-by timers turn on by the heat-up time early", "[benchmark][clock]")
+{
+    Clock clock;
+    REQUIRE(clock.Begin());
+    clock.SetTimeFromUnixTime(WEEK_START);
+    clock.SetDays(0x02);  // Mon
+    clock.SetReadyBy(7 * 60);
+    clock.SetTurnOffAt(9 * 60);
+    clock.SetHeatUpTime(40 * 60);
+    REQUIRE(clock.IsReadyBy());
+
+    // Small changes of the heat-up time do not replan
+    clock.SetHeatUpTime(40 * 60 + CLOCK_HEAT_UP_RESOLUTION - 1);
+    REQUIRE(clock.HeatUpTime() == 40 * 60);
+
+    unsigned long turnedOnAt = 0;
+    for (unsigned long minute = 1; minute < 24 * 60 && !turnedOnAt; ++minute)
+    {
+        Host::AdvanceMillis(60000UL);
+        clock.Update();
+        if (clock.HasNewState() && clock.State() == Clock::State::On)
+            turnedOnAt = minute;
+    }
+    REQUIRE(turnedOnAt == 6 * 60 + 20);
+
+    // A boiler that cooled down more than planned catches up on the window that now started earlier
+    clock.SetTimeFromUnixTime(WEEK_START + 7UL * 24UL * 60UL * 60UL + (6UL * 60UL + 30UL) * 60UL);
+    Host::AdvanceMillis(60000UL);
+    clock.Update();
+    clock.HasNewState();
+    clock.SetHeatUpTime(20 * 60);
+    REQUIRE_FALSE(clock.HasNewState());
+    clock.SetHeatUpTime(45 * 60);
+    REQUIRE(clock.HasNewState());
+    REQUIRE(clock.State() == Clock::State::On);
+
+    // A plain on time does not move
+    clock.SetTurnOnAt(7 * 60);
+    REQUIRE_FALSE(clock.IsReadyBy());
+}
@@ -0,0 +1,287 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "allocationCounter.hpp"
+#include "communicator.hpp"
+#include "snapshot.hpp"
+#include "txQueue.hpp"
+#include "vbm.hpp"
+
+namespace
+{
+// One message per Communicator::Command, as the app sends them
+// The machine loads its settings from the host eeprom, the other cases expect the defaults back
+class KeepSettings final
+{
+  public:
+    KeepSettings() noexcept
+        : setpoints_{SETPOINT_BREW_TEMP, SETPOINT_STEAM_TEMP, SETPOINT_ECO_TEMP, SETPOINT_GROUP_TEMP,
+                     PUMP_PRESSURE_LIMIT},
+          values_{SLEEP_TIMEOUT, HEATER_WATTAGE, TARGET_VOLUME}
+    {
+    }
+    ~KeepSettings()
+    {
+        SETPOINT_BREW_TEMP = setpoints_[0];
+        SETPOINT_STEAM_TEMP = setpoints_[1];
+        SETPOINT_ECO_TEMP = setpoints_[2];
+        SETPOINT_GROUP_TEMP = setpoints_[3];
+        PUMP_PRESSURE_LIMIT = setpoints_[4];
+        SLEEP_TIMEOUT = values_[0];
+        HEATER_WATTAGE = values_[1];
+        TARGET_VOLUME = values_[2];
+    }
+
+  private:
+    float setpoints_[5];
+    uint16_t values_[3];
+};
+
+const char* const MESSAGES[] = {"turnon",          "turnoff",          "setpointbrew:95",   "setpointsteam:130",
+                                "durationtimer:30", "daystimer1:62",    "timer1on:450",      "timer2off:1020",
+                                "setunixtime:1666166400", "updateapp", "updateapp:since:42"};
+}  // namespace
+
+TEST_CASE("Communicator::Update parses each command", "[benchmark][communicator]")
+{
+    Communicator communicator;
+
+    for (const auto message : MESSAGES)
+    {
+        const auto parse = [&] {
+            Serial.HostReceive(message);
+            communicator.Update();
+            return communicator.Command();
+        };
+        REQUIRE(parse() != Communicator::Command::None);
+
+        const auto name = std::string("Communicator::Update ") + message;
+        AllocationCounter::Report(name.c_str(), parse);
+        BENCHMARK(std::string(name)) { return parse(); };
+    }
+
+    // Idle loop without any received byte, which is what runs almost every pass
+    const auto idle = [&] {
+        communicator.Update();
+        return communicator.Command();
+    };
+    AllocationCounter::Report("Communicator::Update idle", idle);
+    BENCHMARK("Communicator::Update idle") { return idle(); };
+}
+
+TEST_CASE("Communicator::Value extracts the number", "[benchmark][communicator]")
+{
+    Communicator communicator;
+    Serial.HostReceive("setunixtime:1666166400");
+    communicator.Update();
+
+    unsigned long value = 0;
+    communicator.Value(value);
+    REQUIRE(value == 1666166400UL);
+
+    const auto extract = [&] {
+        communicator.Value(value);
+        return value;
+    };
+    AllocationCounter::Report("Communicator::Value<unsigned long>", extract);
+    BENCHMARK("Communicator::Value<unsigned long>") { return extract(); };
+
+    // Values are taken after the last ':'
+    Serial.HostReceive("updateapp:since:42");
+    communicator.Update();
+    REQUIRE(communicator.Command() == Communicator::Command::UpdateAppSince);
+    unsigned int since = 0;
+    communicator.Value(since);
+    REQUIRE(since == 42);
+
+    // Decimals are kept for floating point settings
+    Serial.HostReceive("pressurelimit:9.5");
+    communicator.Update();
+    REQUIRE(communicator.Command() == Communicator::Command::PumpPressureLimit);
+    float setpoint = 0;
+    communicator.Value(setpoint);
+    REQUIRE(setpoint == 9.5f);
+    communicator.Value(since);
+    REQUIRE(since == 9);
+
+    const auto extractFloat = [&] {
+        communicator.Value(setpoint);
+        return setpoint;
+    };
+    AllocationCounter::Report("Communicator::Value<float>", extractFloat);
+    BENCHMARK("Communicator::Value<float>") { return extractFloat(); };
+}
+
+TEST_CASE("Communicator rejects timer and profile numbers out of range", "[communicator]")
+{
+    Communicator communicator;
+    const auto receive = [&](const char* Message) {
+        Serial.HostReceive(Message);
+        communicator.Update();
+        return communicator.Command();
+    };
+
+    REQUIRE(receive("timer2on:450") == Communicator::Command::TimerOn);
+    REQUIRE(communicator.Timer() == 1);
+    REQUIRE(receive("profile3segment4duty:50") == Communicator::Command::SegmentDuty);
+    REQUIRE(communicator.Profile() == 2);
+    REQUIRE(communicator.Segment() == 3);
+
+    // 0 is no number, 1 based, and a large one must not wrap around onto a valid one
+    REQUIRE(receive("timer0on:450") == Communicator::Command::TimerOn);
+    REQUIRE(communicator.Timer() == Communicator::NO_INDEX);
+    REQUIRE(receive("profile0segment1duty:50") == Communicator::Command::SegmentDuty);
+    REQUIRE(communicator.Profile() == Communicator::NO_INDEX);
+    REQUIRE(receive("profile257segment1duty:50") == Communicator::Command::SegmentDuty);
+    REQUIRE(communicator.Profile() == Communicator::NO_INDEX);
+    REQUIRE(receive("profile1segment0time:50") == Communicator::Command::SegmentTime);
+    REQUIRE(communicator.Segment() == Communicator::NO_INDEX);
+}
+
+TEST_CASE("TxQueue never blocks and drops the oldest lines", "[benchmark][communicator]")
+{
+    // Empty the queue left over by other cases, then model the 64 byte UART buffer of the Nano
+    Serial.HostSetTxCapacity(-1);
+    while (TxQueue::Pending())
+        TxQueue::Flush();
+    Serial.HostSetTxCapacity(64);
+    Serial.HostDrainTx(1000000);
+    Serial.HostClearTransmitted();
+    Serial.HostSetCaptureTransmitted(true);
+
+    // Only whole lines within the budget go out
+    for (int i = 0; i < 5; ++i)
+        TxLine().Append(">line:").Append(static_cast<long>(i)).Send();
+    TxQueue::Flush(20);
+    REQUIRE(Serial.HostTransmitted() == ">line:0\r\n>line:1\r\n");
+
+    // A full UART takes nothing and the queue keeps the newest lines
+    Serial.HostClearTransmitted();
+    Serial.HostSetTxCapacity(0);
+    const auto dropped = TxQueue::Dropped();
+    for (int i = 5; i < 100; ++i)
+        TxLine().Append(">line:").Append(static_cast<long>(i)).Send();
+    TxQueue::Flush();
+    REQUIRE(Serial.HostTransmitted().empty());
+    REQUIRE(TxQueue::Dropped() > dropped);
+    REQUIRE(TxQueue::Pending() <= TX_QUEUE_SIZE);
+
+    Serial.HostSetTxCapacity(-1);
+    while (TxQueue::Pending())
+        TxQueue::Flush();
+    const auto& transmitted = Serial.HostTransmitted();
+    REQUIRE(transmitted.find(">line:4\r\n") == std::string::npos);
+    REQUIRE(transmitted.size() >= 10);
+    REQUIRE(transmitted.compare(transmitted.size() - 10, 10, ">line:99\r\n") == 0);
+    Serial.HostSetCaptureTransmitted(false);
+
+    const auto sendValue = [] {
+        TxLine().Append(">temp:").Append(93.25, 2).Send();
+        TxQueue::Flush();
+        return TxQueue::Pending();
+    };
+    AllocationCounter::Report("TxLine::Send + TxQueue::Flush", sendValue);
+    BENCHMARK("TxLine::Send + TxQueue::Flush") { return sendValue(); };
+}
+
+TEST_CASE("Snapshot versions only real changes", "[benchmark][communicator]")
+{
+    Snapshot snapshot;
+    snapshot.Set(Snapshot::Field::Temperature, 9350, 10);
+    snapshot.Set(Snapshot::TimerField(1, 2), 1020);
+    const auto version = snapshot.Version();
+    REQUIRE(snapshot.ChangedSince(Snapshot::Field::Temperature, 0));
+    REQUIRE_FALSE(snapshot.ChangedSince(Snapshot::Field::Temperature, version));
+
+    // Noise within the deadband and unchanged values keep the version
+    snapshot.Set(Snapshot::Field::Temperature, 9358, 10);
+    snapshot.Set(Snapshot::TimerField(1, 2), 1020);
+    REQUIRE(snapshot.Version() == version);
+
+    snapshot.Set(Snapshot::Field::Temperature, 9361, 10);
+    REQUIRE(snapshot.ChangedSince(Snapshot::Field::Temperature, version));
+    REQUIRE_FALSE(snapshot.ChangedSince(Snapshot::TimerField(1, 2), version));
+
+    long temperature = 9361;
+    const auto refresh = [&] {
+        snapshot.Set(Snapshot::Field::Temperature, temperature ^= 1, 10);
+        return snapshot.ChangedSince(Snapshot::Field::Temperature, version);
+    };
+    AllocationCounter::Report("Snapshot::Set + ChangedSince", refresh);
+    BENCHMARK("Snapshot::Set + ChangedSince") { return refresh(); };
+}
+
+TEST_CASE("A full updateapp streams through the TxQueue without dropping lines", "[communicator]")
+{
+    const KeepSettings keep;
+    VBM vbm;
+    Serial.HostSetTxCapacity(-1);
+    while (TxQueue::Pending())
+        TxQueue::Flush();
+    // The 63 bytes of the Nano's UART buffer, drained at the baud rate between loops of 10 ms
+    Serial.HostSetTxCapacity(63);
+    Serial.HostDrainTx(1000000);
+    Serial.HostClearTransmitted();
+    Serial.HostSetCaptureTransmitted(true);
+    const auto dropped = TxQueue::Dropped();
+
+    Serial.HostReceive("updateapp");
+    for (int i = 0; i < 500; ++i)
+    {
+        Host::AdvanceMillis(10);
+        Serial.HostDrainTx(10000);
+        vbm.Update();
+    }
+    Serial.HostSetCaptureTransmitted(false);
+    REQUIRE(TxQueue::Dropped() == dropped);
+
+    const auto& transmitted = Serial.HostTransmitted();
+    for (const auto key : {">turnedon:", ">timer1dow:", ">timer2readyby:", ">setpointbrew:", ">setpointgroup:",
+                           ">sleeptimeout:", ">pumpprofile:", ">targetvolume:", ">groupestimate:", ">eta:",
+                           ">heatuptime:", ">boottime:", ">version:"})
+        REQUIRE(transmitted.find(key) != std::string::npos);
+}
+
+TEST_CASE("Timer commands out of range change nothing", "[communicator]")
+{
+    const KeepSettings keep;
+    VBM vbm;
+    const auto receive = [&](const char* Message) {
+        Serial.HostReceive(Message);
+        Host::AdvanceMillis(10);
+        vbm.Update();
+    };
+
+    receive("timer1on:450");
+    const auto writes = EEPROM.HostWrites();
+    REQUIRE(writes > 0);
+    for (const auto message : {"timer0on:450", "timer3on:450", "timer0off:30", "timer200off:30", "daystimer9:62",
+                               "timer9readyby:400", "timer255readyby:400"})
+        receive(message);
+    REQUIRE(EEPROM.HostWrites() == writes);
+}
+
+TEST_CASE("Setting commands out of range change nothing", "[communicator]")
+{
+    const KeepSettings keep;
+    VBM vbm;
+    const auto receive = [&](const char* Message) {
+        Serial.HostReceive(Message);
+        Host::AdvanceMillis(10);
+        vbm.Update();
+    };
+
+    receive("setpointgroup:92.5");
+    REQUIRE(SETPOINT_GROUP_TEMP == 92.5f);
+
+    receive("pressurelimit:9");
+    REQUIRE(PUMP_PRESSURE_LIMIT == 9.0f);
+    const auto writes = EEPROM.HostWrites();
+    for (const auto message : {"setpointgroup:nan", "setpointgroup:-1", "setpointgroup:151", "pressurelimit:nan",
+                               "pressurelimit:-0.5", "pressurelimit:12.5"})
+        receive(message);
+    REQUIRE(SETPOINT_GROUP_TEMP == 92.5f);
+    REQUIRE(PUMP_PRESSURE_LIMIT == 9.0f);
+    REQUIRE(EEPROM.HostWrites() == writes);
+}
@@ -0,0 +1,27 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "eepromMemory.hpp"
+
+TEST_CASE("Eeprom Save and Load", "[benchmark][eeprom]")
+{
+    Eeprom eeprom;
+
+    float setpoint = 96.5f;
+    const auto save = [&] { return eeprom.Save(Eeprom::Parameter::SetpointBrew, setpoint); };
+    REQUIRE(save());
+    AllocationCounter::Report("Eeprom::Save<float>", save);
+    BENCHMARK("Eeprom::Save<float>") { return save(); };
+
+    float loaded = 0;
+    const auto load = [&] { return eeprom.Load(Eeprom::Parameter::SetpointBrew, loaded); };
+    REQUIRE(load());
+    REQUIRE(loaded == setpoint);
+    AllocationCounter::Report("Eeprom::Load<float>", load);
+    BENCHMARK("Eeprom::Load<float>") { return load(); };
+
+    unsigned long timer = 0;
+    const auto loadTimer = [&] { return eeprom.Load(Eeprom::Parameter::Timer1TurnOn, timer); };
+    AllocationCounter::Report("Eeprom::Load<unsigned long>", loadTimer);
+    BENCHMARK("Eeprom::Load<unsigned long>") { return loadTimer(); };
+}
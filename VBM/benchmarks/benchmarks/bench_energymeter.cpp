@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "energyMeter.hpp"
+
+namespace
+{
+constexpr const unsigned long LOOP_TIME = 10;
+constexpr const uint16_t DAY = 20000;
+
+// Runs the loop until the save is written
+void FinishSave(EnergyMeter& Meter, unsigned long& Now)
+{
+    while (Meter.IsSaving())
+        Meter.Update(0, false, EnergyMeter::Usage::Idle, DAY, Now += LOOP_TIME);
+}
+}  // namespace
+
+TEST_CASE("EnergyMeter integrates and persists the counters", "[benchmark][energymeter]")
+{
+    EEPROM.HostErase();
+    HEATER_WATTAGE = 1200;
+    EnergyMeter meter;
+    meter.Begin();
+    REQUIRE(meter.Energy() == 0);
+
+    // A flush does not count as a shot
+    meter.SetBrewing(true, 0);
+    meter.SetBrewing(false, 4000);
+    meter.SetBrewing(true, 0);
+    meter.SetBrewing(false, 25000);
+    REQUIRE(meter.Shots() == 1);
+
+    // An hour at half power while idle is 600 Wh, with the pump on for a minute
+    unsigned long now = 0;
+    for (unsigned long i = 0; i < 3600000UL / LOOP_TIME; ++i)
+    {
+        now += LOOP_TIME;
+        meter.Update(i % 2 ? 1 : 0, i < 60000 / LOOP_TIME, EnergyMeter::Usage::Idle, DAY, now);
+    }
+    REQUIRE(meter.Energy(EnergyMeter::Usage::Idle) >= 599);
+    REQUIRE(meter.Energy(EnergyMeter::Usage::Idle) <= 600);
+    REQUIRE(meter.Energy(EnergyMeter::Usage::HeatUp) == 0);
+    REQUIRE(meter.DayEnergy(0) == meter.Energy());
+    REQUIRE(meter.HeaterOnTime() >= 1799);
+    REQUIRE(meter.PumpOnTime() == 60);
+    REQUIRE(meter.PoweredTime() == 3600);
+
+    // The save after an hour is written a byte per loop, each byte at most once
+    REQUIRE(meter.IsSaving());
+    const auto writes = EEPROM.HostWrites();
+    FinishSave(meter, now);
+    REQUIRE(EEPROM.HostWrites() - writes < 52);
+
+    SECTION("Restored after a reset")
+    {
+        EnergyMeter restored;
+        restored.Begin();
+        REQUIRE(restored.Energy() == meter.Energy());
+        REQUIRE(restored.Shots() == 1);
+        REQUIRE(restored.PumpOnTime() == 60);
+    }
+
+    SECTION("A save cut short falls back to the slot before")
+    {
+        // Two saves: slot 0 holds the first, the second goes to slot 1 and is cut by a reset
+        meter.Update(1, false, EnergyMeter::Usage::Steam, DAY, now += 3600000UL);
+        meter.Save();
+        FinishSave(meter, now);
+        const auto steam = meter.Energy(EnergyMeter::Usage::Steam);
+        REQUIRE(steam >= 1199);
+        meter.Update(1, false, EnergyMeter::Usage::Steam, DAY, now += 3600000UL);
+        meter.Save();
+        for (uint8_t i = 0; i < 10; ++i)
+            meter.Update(0, false, EnergyMeter::Usage::Idle, DAY, now += LOOP_TIME);
+        REQUIRE(meter.IsSaving());
+
+        EnergyMeter restored;
+        restored.Begin();
+        REQUIRE(restored.Energy(EnergyMeter::Usage::Steam) == steam);
+    }
+
+    SECTION("Days move on")
+    {
+        meter.Update(1, false, EnergyMeter::Usage::HeatUp, DAY + 2, now += 3600000UL);
+        REQUIRE(meter.DayEnergy(0) >= 1199);
+        REQUIRE(meter.DayEnergy(1) == 0);
+        REQUIRE(meter.DayEnergy(2) == meter.Energy(EnergyMeter::Usage::Idle));
+        meter.Update(0, false, EnergyMeter::Usage::Idle, DAY + 2 + STATS_DAYS, now += LOOP_TIME);
+        for (uint8_t day = 0; day < STATS_DAYS; ++day)
+            REQUIRE(meter.DayEnergy(day) == 0);
+    }
+
+    const auto update = [&] {
+        now += LOOP_TIME;
+        meter.Update(1, true, EnergyMeter::Usage::Idle, DAY, now);
+        return meter.Energy();
+    };
+    AllocationCounter::Report("EnergyMeter::Update", update);
+    BENCHMARK("EnergyMeter::Update") { return update(); };
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "etaEstimator.hpp"
+
+namespace
+{
+constexpr const unsigned long SAMPLE_INTERVAL = 100;
+
+// Boiler heating at 0.6 degrees/s at full power and losing heat to a 20 degree room, driven by a proportional
+// controller through a time proportioned SSR like the PID of the heater
+struct Boiler
+{
+    double temperature = 20.0;
+    unsigned long now = 0;
+    bool relayOn = false;
+
+    void Step(double Setpoint)
+    {
+        const double duty = Setpoint > 0 ? (Setpoint - temperature) / 2.0 : 0.0;
+        relayOn = (now % static_cast<unsigned long>(WINDOW_SIZE)) < duty * WINDOW_SIZE;
+        temperature += ((relayOn ? 0.6 : 0.0) - 0.002 * (temperature - 20.0)) * SAMPLE_INTERVAL / 1000.0;
+        now += SAMPLE_INTERVAL;
+    }
+};
+
+// Runs until ready and returns the eta predicted after Prediction milliseconds and the actual time it took
+void HeatTo(Boiler& Boiler, Readiness& Readiness, EtaEstimator& Eta, double Setpoint, unsigned long Prediction,
+            unsigned long& Predicted, unsigned long& Took)
+{
+    Readiness.Restart();
+    const auto start = Boiler.now;
+    Predicted = 0;
+    while (!Readiness.IsReady() && Boiler.now - start < 3600000UL)
+    {
+        Boiler.Step(Setpoint);
+        Readiness.Update(Boiler.temperature, Setpoint, Boiler.now);
+        Eta.Update(Boiler.temperature, Setpoint, Boiler.relayOn, Readiness, Boiler.now);
+        if (Boiler.now - start == Prediction)
+            Predicted = Eta.Eta() + Prediction / 1000;
+    }
+    Took = (Boiler.now - start) / 1000;
+    REQUIRE(Readiness.IsReady());
+    REQUIRE(Eta.Eta() == 0);
+}
+}  // namespace
+
+TEST_CASE("EtaEstimator predicts heat-up and cool-down", "[benchmark][eta]")
+{
+    Boiler boiler;
+    Readiness readiness;
+    EtaEstimator eta;
+    unsigned long predicted = 0;
+    unsigned long took = 0;
+
+    // Cold start: the rate is learned on the way up, the prediction after a minute is within 20 %
+    HeatTo(boiler, readiness, eta, 93.0, 60000UL, predicted, took);
+    INFO("cold start predicted " << predicted << " s, took " << took << " s");
+    REQUIRE(eta.HeatingRate() > 0.45);
+    REQUIRE(eta.HeatingRate() < 0.65);
+    REQUIRE(fabs(static_cast<double>(predicted) - took) < 0.2 * took);
+
+    // Brew to steam uses the learned rate right away
+    HeatTo(boiler, readiness, eta, 125.0, 5000UL, predicted, took);
+    INFO("to steam predicted " << predicted << " s, took " << took << " s");
+    REQUIRE(fabs(static_cast<double>(predicted) - took) < 0.2 * took);
+
+    // Back to brew: the boiler has to cool down, which is learned as well
+    HeatTo(boiler, readiness, eta, 93.0, 5000UL, predicted, took);
+    INFO("to brew predicted " << predicted << " s, took " << took << " s, cooling " << eta.CoolingRate());
+    REQUIRE(eta.CoolingRate() > ETA_DEFAULT_COOLING_RATE);
+
+    // Waking up from the eco setpoint is predicted before the heater even starts
+    boiler.temperature = 80.0;
+    const auto wake = eta.Predict(boiler.temperature, 93.0);
+    HeatTo(boiler, readiness, eta, 93.0, 1000UL, predicted, took);
+    INFO("wake up predicted " << wake << " s, took " << took << " s");
+    REQUIRE(fabs(static_cast<double>(wake) - took) < 0.2 * took);
+
+    // Recovery after a shot took the boiler 8 degrees down
+    boiler.temperature -= 8.0;
+    HeatTo(boiler, readiness, eta, 93.0, 1000UL, predicted, took);
+    INFO("recovery predicted " << predicted << " s, took " << took << " s");
+    REQUIRE(fabs(static_cast<double>(predicted) - took) < 0.2 * took);
+
+    const auto update = [&] {
+        boiler.Step(93.0);
+        eta.Update(boiler.temperature, 93.0, boiler.relayOn, readiness, boiler.now);
+        return eta.Eta();
+    };
+    AllocationCounter::Report("EtaEstimator::Update", update);
+    BENCHMARK("EtaEstimator::Update") { return update(); };
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "flightRecorder.hpp"
+
+namespace
+{
+typedef FlightRecorder::Kind Kind;
+typedef FlightRecorder::Cause Cause;
+
+// MCUSR flags of the ATmega328P
+constexpr const uint8_t POWER_ON = 1 << 0;
+constexpr const uint8_t BROWN_OUT = 1 << 2;
+constexpr const uint8_t WATCHDOG = 1 << 3;
+}  // namespace
+
+TEST_CASE("FlightRecorder saves the last entries on error", "[benchmark][flightrecorder]")
+{
+    EEPROM.HostErase();
+    REQUIRE(FlightRecorder::SavedCause() == Cause::None);
+    REQUIRE(FlightRecorder::SavedCount() == 0);
+
+    FlightRecorder::Begin(POWER_ON);
+    for (int i = 0; i < FLIGHT_RECORDER_SIZE + 3; ++i)
+        FlightRecorder::Record(Kind::Temperature, 3, i);
+    FlightRecorder::Persist(Cause::Error);
+
+    REQUIRE(FlightRecorder::SavedCause() == Cause::Error);
+    REQUIRE(FlightRecorder::SavedResetFlags() == POWER_ON);
+    REQUIRE(FlightRecorder::SavedCount() == FLIGHT_RECORDER_SIZE);
+    // The reset entry and the first three temperatures were overwritten, oldest first
+    for (uint8_t i = 0; i < FLIGHT_RECORDER_SIZE; ++i)
+    {
+        const auto entry = FlightRecorder::SavedEntry(i);
+        REQUIRE(entry.kind == Kind::Temperature);
+        REQUIRE(entry.data == 3);
+        REQUIRE(entry.value == i + 3);
+    }
+
+    // Saving the same recording again does not wear the eeprom
+    const auto writes = EEPROM.HostWrites();
+    FlightRecorder::Persist(Cause::Error);
+    REQUIRE(EEPROM.HostWrites() == writes);
+
+    const auto record = [] { FlightRecorder::Record(Kind::Button, 1); };
+    AllocationCounter::Report("FlightRecorder::Record", record);
+    BENCHMARK("FlightRecorder::Record") { return record(); };
+}
+
+TEST_CASE("FlightRecorder keeps the recording over a watchdog or brown-out reset", "[benchmark][flightrecorder]")
+{
+    EEPROM.HostErase();
+    FlightRecorder::Begin(POWER_ON);
+    // Only a power on starts a new recording, without a reason to save it nothing goes to eeprom
+    REQUIRE(FlightRecorder::SavedCause() == Cause::None);
+
+    FlightRecorder::Record(Kind::Transition, 0x14, 0);
+    FlightRecorder::Record(Kind::Command, 2);
+
+    // The RAM survived the reset
+    FlightRecorder::Begin(WATCHDOG);
+    REQUIRE(FlightRecorder::SavedCause() == Cause::Watchdog);
+    REQUIRE(FlightRecorder::SavedResetFlags() == WATCHDOG);
+    REQUIRE(FlightRecorder::SavedCount() == 3);
+    REQUIRE(FlightRecorder::SavedEntry(0).kind == Kind::Reset);
+    REQUIRE(FlightRecorder::SavedEntry(0).data == POWER_ON);
+    REQUIRE(FlightRecorder::SavedEntry(1).kind == Kind::Transition);
+    REQUIRE(FlightRecorder::SavedEntry(1).data == 0x14);
+    REQUIRE(FlightRecorder::SavedEntry(2).kind == Kind::Command);
+
+    // The new run continues the ring behind the reset it was started by
+    FlightRecorder::Begin(BROWN_OUT);
+    REQUIRE(FlightRecorder::SavedCause() == Cause::BrownOut);
+    REQUIRE(FlightRecorder::SavedCount() == 4);
+    REQUIRE(FlightRecorder::SavedEntry(3).kind == Kind::Reset);
+    REQUIRE(FlightRecorder::SavedEntry(3).data == WATCHDOG);
+
+    // An external reset neither saves nor clears
+    FlightRecorder::Begin(1 << 1);
+    REQUIRE(FlightRecorder::SavedCause() == Cause::BrownOut);
+    REQUIRE(FlightRecorder::SavedCount() == 4);
+}
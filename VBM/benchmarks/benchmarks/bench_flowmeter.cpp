@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "flowMeter.hpp"
+
+namespace
+{
+// Feeds a square wave of Flow ml/s to the flow meter pin for Duration milliseconds, the interrupt sees every
+// change of the pin, the loop runs every millisecond
+void Pump(double Flow, unsigned long Duration)
+{
+    const double period = Flow > 0 ? 1e6 / (Flow * FLOW_METER_PULSES_PER_ML) : 0;
+    static double phase = 0;
+    for (unsigned long tick = 0; tick < Duration; ++tick)
+    {
+        Host::AdvanceMillis(1);
+        if (period)
+        {
+            phase += 1000;
+            if (phase >= period)
+                phase -= period;
+        }
+        const uint8_t level = period && phase < period / 2 ? HIGH : LOW;
+        if (level != Host::pinLevel[FLOW_METER_PIN])
+        {
+            Host::pinLevel[FLOW_METER_PIN] = level;
+            FlowMeter::PinChange();
+        }
+        FlowMeter::Update(millis());
+    }
+}
+}  // namespace
+
+TEST_CASE("FlowMeter counts a pulse train into volume and flow", "[benchmark][flowmeter]")
+{
+    FlowMeter::Begin();
+    Pump(0, 100);
+    FlowMeter::Reset();
+    REQUIRE(FlowMeter::Volume() == 0);
+    REQUIRE(FlowMeter::Flow() == 0);
+
+    // 2 ml/s are only about 4 pulses per second, the flow is still exact from the pulse times
+    Pump(2.0, 10000);
+    REQUIRE(fabs(FlowMeter::Volume() - 20.0) <= 1 / FLOW_METER_PULSES_PER_ML);
+    REQUIRE(fabs(FlowMeter::Flow() - 2.0) < 0.02);
+
+    Pump(4.0, 2000);
+    REQUIRE(fabs(FlowMeter::Flow() - 4.0) < 0.05);
+    REQUIRE(fabs(FlowMeter::Volume() - 28.0) <= 2 / FLOW_METER_PULSES_PER_ML);
+
+    // Only rising edges count, a pin change interrupt of another pin leaves the count alone
+    const double volume = FlowMeter::Volume();
+    FlowMeter::PinChange();
+    FlowMeter::PinChange();
+    REQUIRE(FlowMeter::Volume() == volume);
+
+    // No pulses: the flow falls to 0, and after the pause it is measured anew instead of averaged over the pause
+    Pump(0, FLOW_TIMEOUT + FLOW_INTERVAL);
+    REQUIRE(FlowMeter::Flow() == 0);
+    Pump(1.0, 3000);
+    REQUIRE(fabs(FlowMeter::Flow() - 1.0) < 0.02);
+
+    FlowMeter::Reset();
+    REQUIRE(FlowMeter::Volume() == 0);
+
+    const auto update = [] {
+        Host::AdvanceMillis(FLOW_INTERVAL);
+        Host::pinLevel[FLOW_METER_PIN] = !Host::pinLevel[FLOW_METER_PIN];
+        FlowMeter::PinChange();
+        FlowMeter::Update(millis());
+        return FlowMeter::Flow();
+    };
+    AllocationCounter::Report("FlowMeter::Update", update);
+    BENCHMARK("FlowMeter::Update") { return update(); };
+}
@@ -0,0 +1,176 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "heater.hpp"
+
+TEST_CASE("Heater hot paths", "[benchmark][heater]")
+{
+    Host::rtdTemperature[BOILER_TEMP_CS_PIN] = SETPOINT_BREW_TEMP - 10;
+    Heater heater;
+    heater.Begin();
+    heater.SetHeaterTo(Heater::State::BrewTemp);
+
+    const auto isReady = [&] { return heater.IsReady(); };
+    AllocationCounter::Report("Heater::IsReady", isReady);
+    BENCHMARK("Heater::IsReady") { return isReady(); };
+
+    // One loop pass: a step of the temperature readout, PID computation and SSR output, 100 ms apart
+    const auto step = [&] {
+        Host::AdvanceMillis(100);
+        heater.Update();
+        return heater.CurrentTemperature();
+    };
+    AllocationCounter::Report("Heater::Update (one PID step)", step);
+    BENCHMARK("Heater::Update (one PID step)") { return step(); };
+}
+
+TEST_CASE("Heater reads boiler and group interleaved without waiting", "[heater]")
+{
+    Host::rtdPresent[GROUP_TEMP_CS_PIN] = false;
+    Heater single;
+    single.Begin();
+    REQUIRE_FALSE(single.HasGroupSensor());
+    Host::rtdPresent[GROUP_TEMP_CS_PIN] = true;
+
+    Host::rtdTemperature[BOILER_TEMP_CS_PIN] = 95;
+    Host::rtdTemperature[GROUP_TEMP_CS_PIN] = 85;
+    Supervisor::Begin();
+    Heater heater;
+    heater.Begin();
+    REQUIRE(heater.HasGroupSensor());
+    REQUIRE(fabs(heater.CurrentTemperature() - 95) < 0.1);
+    REQUIRE(fabs(heater.GroupTemperature() - 85) < 0.1);
+
+    // A loop every millisecond: no pass waits for a conversion and none takes more than one step
+    Host::rtdTemperature[BOILER_TEMP_CS_PIN] = 95.2;
+    Host::rtdTemperature[GROUP_TEMP_CS_PIN] = 86;
+    unsigned int boilerReadings = 0;
+    unsigned int groupReadings = 0;
+    double boiler = heater.CurrentTemperature();
+    double group = heater.GroupTemperature();
+    for (int i = 0; i < 3000; ++i)
+    {
+        Host::AdvanceMillis(1);
+        Supervisor::Tick();
+        const auto startedAt = micros();
+        const auto transactions = Host::spiTransactions;
+        heater.Update();
+        REQUIRE(micros() == startedAt);
+        REQUIRE(Host::spiTransactions - transactions <= 2);
+        // Alternate the temperatures a little so every reading shows
+        if (heater.CurrentTemperature() != boiler)
+        {
+            boiler = heater.CurrentTemperature();
+            ++boilerReadings;
+            Host::rtdTemperature[BOILER_TEMP_CS_PIN] = boiler < 95.1 ? 95.2 : 95;
+        }
+        if (heater.GroupTemperature() != group)
+        {
+            group = heater.GroupTemperature();
+            ++groupReadings;
+            Host::rtdTemperature[GROUP_TEMP_CS_PIN] = group < 85.5 ? 86 : 85;
+        }
+    }
+    // A boiler reading every conversion, the group once a second in between
+    REQUIRE(boilerReadings >= 3000 / (RtdChannel::BIAS_TIME + RtdChannel::CONVERSION_TIME + 2));
+    REQUIRE(groupReadings >= 3000 / (GROUP_TEMP_INTERVAL + RtdChannel::BIAS_TIME + RtdChannel::CONVERSION_TIME + 2));
+    REQUIRE(groupReadings <= 3);
+    // Every boiler reading reached the supervisor
+    REQUIRE(Supervisor::Tripped() == Supervisor::Fault::None);
+}
+
+TEST_CASE("GroupCascade trims the boiler setpoint", "[heater]")
+{
+    GroupCascade cascade;
+    // The group 2 degrees short: proportional trim at once, the integral adds up
+    REQUIRE(cascade.Update(91, 93, 0) == Approx(2 * GROUP_KP));
+    unsigned long now = 0;
+    for (int i = 0; i < 100; ++i)
+        cascade.Update(91, 93, now += GROUP_TEMP_INTERVAL);
+    REQUIRE(cascade.Trim() == Approx(2 * GROUP_KP + 2 * GROUP_KI * 100 * GROUP_TEMP_INTERVAL / 1000.0));
+
+    // Never beyond the range, and the integral does not wind up past it
+    for (int i = 0; i < 10000; ++i)
+        cascade.Update(60, 93, now += GROUP_TEMP_INTERVAL);
+    REQUIRE(cascade.Trim() == GROUP_CASCADE_RANGE);
+    REQUIRE(cascade.Update(93, 93, now += GROUP_TEMP_INTERVAL) == Approx(GROUP_CASCADE_RANGE));
+    REQUIRE(cascade.Update(95, 93, now += GROUP_TEMP_INTERVAL) < GROUP_CASCADE_RANGE - 2 * GROUP_KP + 0.1);
+
+    cascade.Reset();
+    REQUIRE(cascade.Trim() == 0);
+}
+
+TEST_CASE("GroupObserver estimates the group from the boiler", "[benchmark][heater]")
+{
+    // Held at 93 degrees with the power the model loses there, the group settles where its heat from the boiler
+    // and its loss to the room are even
+    const double boiler = 93;
+    const double group = (boiler / GROUP_HEAT_TIME + AMBIENT_TEMP / GROUP_LOSS_TIME) /
+                         (1 / GROUP_HEAT_TIME + 1 / GROUP_LOSS_TIME);
+    const double rate = ETA_DEFAULT_HEATING_RATE;
+    const double power = ((boiler - AMBIENT_TEMP) / BOILER_LOSS_TIME +
+                          (boiler - group) * GROUP_CAPACITY_RATIO / GROUP_HEAT_TIME) / rate;
+
+    GroupObserver observer;
+    unsigned long now = 0;
+    observer.Reset(boiler, AMBIENT_TEMP, now);
+    REQUIRE_FALSE(observer.IsDue(now + OBSERVER_INTERVAL - 1));
+    REQUIRE(observer.IsDue(now + OBSERVER_INTERVAL));
+    // The group takes the better part of an hour
+    for (unsigned long i = 0; i < 10000 / OBSERVER_INTERVAL; ++i)
+        observer.Update(boiler, power, false, rate, now += OBSERVER_INTERVAL);
+    REQUIRE(observer.Boiler() == Approx(boiler).margin(0.5));
+    REQUIRE(observer.Group() < AMBIENT_TEMP + 2);
+    for (long i = 0; i < 4L * 3600 * 1000 / OBSERVER_INTERVAL; ++i)
+        observer.Update(boiler, power, false, rate, now += OBSERVER_INTERVAL);
+    REQUIRE(observer.Boiler() == Approx(boiler).margin(0.05));
+    REQUIRE(observer.Group() == Approx(group).margin(0.5));
+
+    // A shot flushes the group towards the boiler, the boiler reading drops with the fresh water
+    const double settled = observer.Group();
+    for (unsigned long i = 0; i < 30000 / OBSERVER_INTERVAL; ++i)
+        observer.Update(boiler - 2, 1, true, rate, now += OBSERVER_INTERVAL);
+    REQUIRE(observer.Group() > settled + 3);
+    REQUIRE(observer.Group() < boiler);
+
+    const auto step = [&] {
+        observer.Update(boiler, power, false, rate, now += OBSERVER_INTERVAL);
+        return observer.Group();
+    };
+    AllocationCounter::Report("GroupObserver::Update", step);
+    BENCHMARK("GroupObserver::Update") { return step(); };
+}
+
+TEST_CASE("Heater trims the brew setpoint with the estimate without a group sensor", "[heater]")
+{
+    Host::rtdPresent[GROUP_TEMP_CS_PIN] = false;
+    Host::rtdTemperature[BOILER_TEMP_CS_PIN] = SETPOINT_BREW_TEMP;
+    Supervisor::Begin();
+    Heater heater;
+    heater.Begin();
+    REQUIRE_FALSE(heater.HasGroupSensor());
+    // Starts where the boiler is
+    REQUIRE(heater.GroupEstimate() == Approx(heater.CurrentTemperature()).margin(0.01));
+    heater.SetHeaterTo(Heater::State::BrewTemp);
+
+    // Left to cool it falls behind the boiler
+    for (int i = 0; i < 600; ++i)
+    {
+        Host::AdvanceMillis(100);
+        heater.Update();
+    }
+    REQUIRE(heater.GroupEstimate() < heater.CurrentTemperature());
+
+    // At the brew setpoint the boiler is left alone, a group setpoint above the estimate heats it
+    REQUIRE(heater.Power() == 0);
+    SETPOINT_GROUP_TEMP = heater.GroupEstimate() + GROUP_CASCADE_RANGE;
+    for (int i = 0; i < 10; ++i)
+    {
+        Host::AdvanceMillis(100);
+        heater.Update();
+    }
+    REQUIRE(heater.Power() > 0);
+    SETPOINT_GROUP_TEMP = 0;
+    Host::rtdPresent[GROUP_TEMP_CS_PIN] = true;
+    REQUIRE(Supervisor::Tripped() == Supervisor::Fault::None);
+}
@@ -0,0 +1,41 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "led.hpp"
+
+TEST_CASE("LED::Tick", "[benchmark][led]")
+{
+    LED led;
+    led.ShowStatus(LED::Signal::Gallop);
+
+    // Gallop 1010 1000: three 312.5 ms steps on within BLINK_INTERVAL
+    unsigned int onTicks = 0;
+    for (unsigned int i = 0; i < BLINK_INTERVAL; ++i)
+    {
+        LED::Tick();
+        onTicks += Host::pinLevel[LED_PIN];
+    }
+    REQUIRE(onTicks >= 3 * (BLINK_INTERVAL / 8) - 1);
+    REQUIRE(onTicks <= 3 * (BLINK_INTERVAL / 8) + 2);
+
+    // An error overrides the status until it is cleared
+    led.Show(LED::Priority::Error, LED::Signal::Whole);
+    LED::Tick();
+    REQUIRE(Host::pinLevel[LED_PIN] == HIGH);
+    led.Clear(LED::Priority::Error);
+    led.ShowStatus(LED::Signal::Off);
+    LED::Tick();
+    REQUIRE(Host::pinLevel[LED_PIN] == LOW);
+
+    led.ShowStatus(LED::Signal::Gallop);
+    const auto tick = [&] {
+        LED::Tick();
+        return Host::pinLevel[LED_PIN];
+    };
+    AllocationCounter::Report("LED::Tick", tick);
+    BENCHMARK("LED::Tick") { return tick(); };
+
+    led.Breathe(LED::Priority::Status);
+    AllocationCounter::Report("LED::Tick breathing", tick);
+    BENCHMARK("LED::Tick breathing") { return tick(); };
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "allocationCounter.hpp"
+#include "logger.hpp"
+#include "txQueue.hpp"
+
+namespace
+{
+const char FORMAT[] PROGMEM = "Turn on at: {} <= {}, temp {}";
+
+// Hex text of the little endian bytes of a value, as the logger sends it
+template <class T>
+std::string Hex(T Value)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    const auto bytes = reinterpret_cast<const uint8_t*>(&Value);
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        hex += HEX_DIGITS[bytes[i] >> 4];
+        hex += HEX_DIGITS[bytes[i] & 0x0F];
+    }
+    return hex;
+}
+}  // namespace
+
+TEST_CASE("Logger::Log", "[benchmark][logger]")
+{
+    Serial.HostSetTxCapacity(-1);
+    while (TxQueue::Pending())
+        TxQueue::Flush();
+    Serial.HostClearTransmitted();
+    Serial.HostSetCaptureTransmitted(true);
+
+    // Format id, then tag and bytes per argument
+    Logger::Log(FORMAT, 1666166400UL, static_cast<uint8_t>(7), 93.5);
+    TxQueue::Flush();
+    const auto expected = "~" + Hex(static_cast<uint16_t>(reinterpret_cast<uintptr_t>(FORMAT))) + "14" +
+                          Hex(static_cast<uint32_t>(1666166400UL)) + "11" + Hex(static_cast<uint8_t>(7)) + "24" +
+                          Hex(93.5f) + "\r\n";
+    REQUIRE(Serial.HostTransmitted() == expected);
+
+    // Strings are cut to the line length and keep their length byte
+    Serial.HostClearTransmitted();
+    Logger::Log(FORMAT, "a message far too long to fit into a single record of the log");
+    TxQueue::Flush();
+    const auto& line = Serial.HostTransmitted();
+    REQUIRE(line.size() <= TX_LINE_LENGTH + 2u);
+    REQUIRE(line.compare(5, 2, "30") == 0);
+    REQUIRE(std::stoul(line.substr(7, 2), nullptr, 16) * 2 == line.size() - 11);
+    Serial.HostSetCaptureTransmitted(false);
+
+    unsigned long unixTime = 1666166400UL;
+    const auto log = [&] {
+        Logger::Log(FORMAT, ++unixTime, static_cast<uint8_t>(7), 93.5);
+        TxQueue::Flush();
+        return TxQueue::Pending();
+    };
+    AllocationCounter::Report("Logger::Log", log);
+    BENCHMARK("Logger::Log") { return log(); };
+}
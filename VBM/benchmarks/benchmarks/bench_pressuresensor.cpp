@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "pressureSensor.hpp"
+
+namespace
+{
+constexpr const uint8_t CONVERSIONS_PER_MS = 10;
+
+// Output of the sensor at Pressure bar as fraction of the supply
+double Ratio(double Pressure) { return PRESSURE_SENSOR_ZERO + Pressure / PRESSURE_SENSOR_MAX * PRESSURE_SENSOR_SPAN; }
+
+// Converts Ratio for Duration milliseconds with the loop running every millisecond. The noise of the pump spreads
+// the conversions over the two nearest ADC steps, so they average out to the exact level
+void Convert(double Ratio, unsigned long Duration)
+{
+    static uint8_t noise = 0;
+    for (unsigned long tick = 0; tick < Duration; ++tick)
+    {
+        Host::AdvanceMillis(1);
+        for (uint8_t i = 0; i < CONVERSIONS_PER_MS; ++i)
+        {
+            noise = (noise + 1) % 16;
+            PressureSensor::Sample(static_cast<uint16_t>(Ratio * 1024 + (noise + 0.5) / 16));
+        }
+        PressureSensor::Update(millis());
+    }
+}
+}  // namespace
+
+TEST_CASE("PressureSensor oversamples and filters the ADC", "[benchmark][pressuresensor]")
+{
+    PressureSensor::Begin();
+
+    // A missing sensor is pulled to 0 V
+    Convert(0, 1000);
+    REQUIRE_FALSE(PressureSensor::IsPresent());
+    REQUIRE(PressureSensor::Pressure() == 0);
+
+    // Atmospheric pressure
+    Convert(Ratio(0), 2000);
+    REQUIRE(PressureSensor::IsPresent());
+    REQUIRE(PressureSensor::Pressure() < 0.01);
+
+    // A step to 9 bar follows with the filter time constant
+    Convert(Ratio(9), PRESSURE_FILTER_TIME);
+    REQUIRE(PressureSensor::Pressure() > 9 * 0.6);
+    REQUIRE(PressureSensor::Pressure() < 9 * 0.7);
+    Convert(Ratio(9), 10 * PRESSURE_FILTER_TIME);
+    REQUIRE(fabs(PressureSensor::Pressure() - 9) < 0.01);
+
+    // Between two ADC steps: one step is 0.015 bar, the oversampling resolves a quarter of it
+    const double step = PRESSURE_SENSOR_MAX / PRESSURE_SENSOR_SPAN / 1024;
+    Convert(Ratio(9) + 0.25 / 1024, 10 * PRESSURE_FILTER_TIME);
+    REQUIRE(fabs(PressureSensor::Pressure() - (9 + step / 4)) < step / 8);
+
+    const auto update = [] {
+        Host::AdvanceMillis(1);
+        for (uint8_t i = 0; i < CONVERSIONS_PER_MS; ++i)
+            PressureSensor::Sample(717);
+        PressureSensor::Update(millis());
+        return PressureSensor::Pressure();
+    };
+    AllocationCounter::Report("PressureSensor::Update", update);
+    BENCHMARK("PressureSensor::Update") { return update(); };
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "pumpProfile.hpp"
+
+namespace
+{
+// Runs the loop and the ticks for Duration milliseconds and returns the share of mains cycles the pump ran
+double Run(unsigned long Duration)
+{
+    unsigned long cycles = 0;
+    unsigned long running = 0;
+    for (unsigned long tick = 0; tick < Duration; ++tick)
+    {
+        Host::AdvanceMillis(1);
+        PumpProfile::Tick();
+        PumpProfile::Update(millis());
+        if (tick % PumpProfile::CYCLE_TICKS == 0)
+        {
+            ++cycles;
+            running += Host::pinLevel[PUMP_SSR_PIN];
+        }
+    }
+    return static_cast<double>(running) / cycles;
+}
+}  // namespace
+
+TEST_CASE("PumpProfile runs pre-infusion, pause and full power", "[benchmark][pumpprofile]")
+{
+    PumpProfile::SetSegment(0, PumpProfile::Segment{30, 40});  // 30 % for 4 s
+    PumpProfile::SetSegment(1, PumpProfile::Segment{0, 30});   // pause for 3 s
+    PumpProfile::SetSegment(2, PumpProfile::Segment{0, 0});    // then full power
+    PumpProfile::SetSegment(3, PumpProfile::Segment{0, 0});
+
+    PumpProfile::Start(millis());
+    REQUIRE(PumpProfile::IsRunning());
+    REQUIRE(PumpProfile::CurrentSegment() == 0);
+    const double preInfusion = Run(4000);
+    REQUIRE(PumpProfile::CurrentSegment() == 1);
+    const double pause = Run(3000);
+    REQUIRE(PumpProfile::CurrentSegment() == PUMP_PROFILE_SEGMENTS);
+    const double full = Run(3000);
+    INFO("pre-infusion " << preInfusion << ", pause " << pause << ", full " << full);
+    REQUIRE(fabs(preInfusion - 0.3) < 0.02);
+    REQUIRE(pause < 0.01);
+    REQUIRE(full == 1.0);
+
+    PumpProfile::Stop();
+    REQUIRE(Host::pinLevel[PUMP_SSR_PIN] == 0);
+    REQUIRE(Run(100) == 0);
+
+    // Erased eeprom ends the profile as well: plain on
+    PumpProfile::SetSegment(0, PumpProfile::Segment{0xFF, 0xFF});
+    PumpProfile::Start(millis());
+    REQUIRE(PumpProfile::CurrentSegment() == PUMP_PROFILE_SEGMENTS);
+    REQUIRE(Run(1000) == 1.0);
+
+    // A segment without time holds until the lever goes up
+    PumpProfile::SetSegment(0, PumpProfile::Segment{50, 0});
+    PumpProfile::Start(millis());
+    REQUIRE(fabs(Run(10000) - 0.5) < 0.02);
+    REQUIRE(PumpProfile::CurrentSegment() == 0);
+
+    // Half way into the band below the pressure limit the pump runs at half its duty, at the limit it stops
+    PUMP_PRESSURE_LIMIT = 9;
+    PumpProfile::LimitPressure(PUMP_PRESSURE_LIMIT - PUMP_PRESSURE_BAND / 2);
+    REQUIRE(fabs(Run(10000) - 0.25) < 0.02);
+    PumpProfile::LimitPressure(PUMP_PRESSURE_LIMIT);
+    REQUIRE(Run(1000) == 0);
+    PUMP_PRESSURE_LIMIT = 0;
+    PumpProfile::LimitPressure(PUMP_PRESSURE_LIMIT);
+    REQUIRE(fabs(Run(10000) - 0.5) < 0.02);
+
+    const auto tick = [] {
+        PumpProfile::Tick();
+        return Host::pinLevel[PUMP_SSR_PIN];
+    };
+    AllocationCounter::Report("PumpProfile::Tick", tick);
+    BENCHMARK("PumpProfile::Tick") { return tick(); };
+    PumpProfile::Stop();
+}
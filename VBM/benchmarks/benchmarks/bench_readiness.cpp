@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "readiness.hpp"
+
+namespace
+{
+constexpr const double SETPOINT = 93.0;
+constexpr const unsigned long SAMPLE_INTERVAL = 100;
+
+// Heat-up at 1 degree/s, then a damped overshoot of 3.5 degrees around the setpoint, with readout noise
+double Temperature(unsigned long Now)
+{
+    const double seconds = Now / 1000.0;
+    const double noise = (Now / SAMPLE_INTERVAL) % 2 ? 0.03 : -0.03;
+    const double reachedAt = SETPOINT - 20.0;
+    if (seconds < reachedAt)
+        return 20.0 + seconds + noise;
+    const double t = seconds - reachedAt;
+    return SETPOINT + 3.5 * exp(-t / 60.0) * sin(2 * 3.14159265 * t / 80.0) + noise;
+}
+}  // namespace
+
+TEST_CASE("Readiness waits for the overshoot to settle", "[benchmark][readiness]")
+{
+    Readiness readiness;
+    unsigned long firstInBand = 0;
+    unsigned long readyAt = 0;
+    uint8_t confidenceInBand = 0;
+    for (unsigned long now = 0; now < 600000UL && !readyAt; now += SAMPLE_INTERVAL)
+    {
+        const double temperature = Temperature(now);
+        readiness.Update(temperature, SETPOINT, now);
+        const bool inBand = fabs(temperature - SETPOINT) < IS_READY_RANGE;
+        if (inBand && !firstInBand)
+            firstInBand = now;
+        if (!inBand)
+            REQUIRE(readiness.Confidence() == 0);
+        if (now == firstInBand + READY_HOLD_TIME / 2)
+            confidenceInBand = readiness.Confidence();
+        if (readiness.IsReady())
+        {
+            readyAt = now;
+            REQUIRE(fabs(readiness.Slope()) <= READY_MAX_SLOPE);
+        }
+    }
+
+    // The band check alone would have been ready on the way up, mid overshoot
+    REQUIRE(firstInBand > 0);
+    REQUIRE(readyAt >= firstInBand + READY_HOLD_TIME);
+    // Not at a turning point of the overshoot, only once it died down
+    REQUIRE(3.5 * exp(-(readyAt / 1000.0 - (SETPOINT - 20.0)) / 60.0) < 1.0);
+    REQUIRE(confidenceInBand > 0);
+    REQUIRE(confidenceInBand < 100);
+    REQUIRE(readiness.Confidence() == 100);
+
+    // A new setpoint starts over
+    readiness.Restart();
+    REQUIRE_FALSE(readiness.IsReady());
+    REQUIRE(readiness.Confidence() == 0);
+
+    unsigned long now = readyAt;
+    const auto update = [&] {
+        now += SAMPLE_INTERVAL;
+        readiness.Update(Temperature(now), SETPOINT, now);
+        return readiness.Confidence();
+    };
+    AllocationCounter::Report("Readiness::Update", update);
+    BENCHMARK("Readiness::Update") { return update(); };
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "sigmaDelta.hpp"
+#include "supervisor.hpp"
+
+namespace
+{
+// Boiler as two nodes: the heating element with little heat capacity and the water the RTD measures, losing heat
+// to a 20 degree room. 1000 W at 30 % power keep the water at 80 degrees.
+struct Boiler
+{
+    static constexpr const double HEATER_POWER = 1000.0;      // W
+    static constexpr const double ELEMENT_CAPACITY = 150.0;   // J/K
+    static constexpr const double WATER_CAPACITY = 1500.0;    // J/K
+    static constexpr const double ELEMENT_TO_WATER = 50.0;    // W/K
+    static constexpr const double WATER_TO_ROOM = 5.0;        // W/K
+
+    double element;
+    double water;
+
+    explicit Boiler(double Power)
+    {
+        // Start in equilibrium to only see the ripple
+        water = 20.0 + HEATER_POWER * Power / WATER_TO_ROOM;
+        element = water + HEATER_POWER * Power / ELEMENT_TO_WATER;
+    }
+
+    void Step(bool Heating, double Seconds)
+    {
+        const double toWater = (element - water) * ELEMENT_TO_WATER;
+        element += ((Heating ? HEATER_POWER : 0.0) - toWater) * Seconds / ELEMENT_CAPACITY;
+        water += (toWater - (water - 20.0) * WATER_TO_ROOM) * Seconds / WATER_CAPACITY;
+    }
+};
+
+// Peak to peak of the water temperature over a minute, stepped in ticks, after a minute to settle
+template <class F>
+double Ripple(double Power, F SsrOn)
+{
+    Boiler boiler(Power);
+    double low = 1000;
+    double high = -1000;
+    for (unsigned long tick = 0; tick < 120UL * TICK_FREQUENCY; ++tick)
+    {
+        boiler.Step(SsrOn(tick), 1.0 / TICK_FREQUENCY);
+        if (tick < 60UL * TICK_FREQUENCY)
+            continue;
+        low = boiler.water < low ? boiler.water : low;
+        high = boiler.water > high ? boiler.water : high;
+    }
+    return high - low;
+}
+}  // namespace
+
+TEST_CASE("SigmaDelta spreads the power over half-cycles", "[benchmark][sigmadelta]")
+{
+    // A trip latched by an earlier test would hold the SSR low
+    Supervisor::Begin();
+    SigmaDelta::SetPower(0.3);
+    unsigned int on = 0;
+    unsigned int longestRun = 0;
+    unsigned int run = 0;
+    for (unsigned int halfCycle = 0; halfCycle < 1000; ++halfCycle)
+    {
+        SigmaDelta::HalfCycle();
+        const bool high = Host::pinLevel[BOILER_SSR_PIN] == HIGH;
+        on += high;
+        run = high ? run + 1 : 0;
+        longestRun = run > longestRun ? run : longestRun;
+    }
+    REQUIRE(on >= 299);
+    REQUIRE(on <= 301);
+    REQUIRE(longestRun == 1);
+
+    // Without zero-cross pulses the ticker clocks the half-cycles
+    SigmaDelta::SetPower(0);
+    for (uint8_t tick = 0; tick < 2 * SigmaDelta::HALF_CYCLE_TICKS; ++tick)
+        SigmaDelta::Tick();
+    REQUIRE(Host::pinLevel[BOILER_SSR_PIN] == LOW);
+
+    SigmaDelta::SetPower(0.5);
+    AllocationCounter::Report("SigmaDelta::Tick", SigmaDelta::Tick);
+    BENCHMARK("SigmaDelta::Tick") { return SigmaDelta::Tick(); };
+}
+
+TEST_CASE("SigmaDelta ripple against the time proportional window", "[benchmark][sigmadelta]")
+{
+    Supervisor::Begin();
+    constexpr const double POWER = 0.3;
+    const unsigned long window = WINDOW_SIZE * TICK_FREQUENCY / 1000;
+    const double windowRipple = Ripple(POWER, [&](unsigned long Tick) { return Tick % window < POWER * window; });
+
+    // The power is quantized to 1/255, start in the equilibrium of the power actually put out
+    SigmaDelta::SetPower(POWER);
+    const double sigmaDeltaRipple = Ripple(SigmaDelta::Power(), [](unsigned long) {
+        SigmaDelta::Tick();
+        return Host::pinLevel[BOILER_SSR_PIN] == HIGH;
+    });
+    SigmaDelta::SetPower(0);
+
+    std::cout << std::left << std::setw(40) << "Ripple time proportional window" << std::right << std::setw(10)
+              << std::setprecision(5) << windowRipple << " degrees" << std::endl;
+    std::cout << std::left << std::setw(40) << "Ripple sigma-delta half-cycles" << std::right << std::setw(10)
+              << std::setprecision(5) << sigmaDeltaRipple << " degrees" << std::endl;
+    REQUIRE(sigmaDeltaRipple * 20 < windowRipple);
+}
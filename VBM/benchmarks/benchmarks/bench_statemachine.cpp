@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "stateMachine.hpp"
+
+namespace
+{
+typedef enum StateMachine::State State;
+typedef StateMachine::Event Event;
+
+bool IsBrewState(State Value)
+{
+    return Value == State::HeatingUpBrew || Value == State::IdleBrew || Value == State::CoolingDown;
+}
+
+bool IsSteamState(State Value) { return Value == State::HeatingUpSteam || Value == State::IdleSteam; }
+}  // namespace
+
+TEST_CASE("StateMachine table holds for every state and event", "[benchmark][statemachine]")
+{
+    for (int8_t from = -1; from < StateMachine::STATES - 1; ++from)
+    {
+        for (uint8_t event = 0; event < StateMachine::EVENTS; ++event)
+        {
+            const auto state = static_cast<State>(from);
+            const auto transition = StateMachine::Lookup(state, static_cast<Event>(event));
+            INFO("state " << static_cast<int>(from) << " event " << static_cast<int>(event));
+            const auto next = transition.next;
+            const auto actions = transition.actions;
+
+            REQUIRE(static_cast<int8_t>(next) >= -1);
+            REQUIRE(static_cast<int8_t>(next) < StateMachine::STATES - 1);
+
+            // At most one heater setpoint per transition, and it matches the state we end up in
+            const auto heaterActions = actions & (StateMachine::HeatOff | StateMachine::HeatBrew |
+                                                  StateMachine::HeatSteam | StateMachine::HeatEco);
+            REQUIRE((heaterActions & (heaterActions - 1)) == 0);
+            if (actions & StateMachine::HeatBrew)
+                REQUIRE(IsBrewState(next));
+            if (actions & StateMachine::HeatSteam)
+                REQUIRE(IsSteamState(next));
+            if (actions & StateMachine::HeatOff)
+                REQUIRE((next == State::Off || next == State::Error));
+            if (actions & StateMachine::HeatEco)
+                REQUIRE(next == State::Sleep);
+
+            // Off and error always leave heater and pump off
+            if ((next == State::Off || next == State::Error) && next != state)
+                REQUIRE((actions & StateMachine::HeatOff));
+            if ((next == State::Off || next == State::Error) && next != state)
+                REQUIRE((actions & StateMachine::PumpOff));
+            REQUIRE_FALSE(((next == State::Off || next == State::Error) && (actions & StateMachine::TogglePump)));
+
+            // Turning on or off from outside is reported to the app
+            if (next == State::Off && state != State::Off)
+                REQUIRE((actions & StateMachine::ReportOff));
+            if ((state == State::Off || state == State::Sleep) && IsBrewState(next))
+                REQUIRE((actions & StateMachine::ReportOn));
+
+            // An error is only left by turning the machine off on purpose
+            if (state == State::Error && next != State::Error)
+            {
+                REQUIRE((static_cast<Event>(event) == Event::LongPress ||
+                         static_cast<Event>(event) == Event::AppTurnOff));
+                REQUIRE(next == State::Off);
+            }
+
+            // The app turning the machine on always stops the pump
+            if (static_cast<Event>(event) == Event::AppTurnOn && state != State::Error)
+                REQUIRE((actions & StateMachine::PumpOff));
+
+            // Heater readiness never changes the heater, it only settles the heating states
+            if (static_cast<Event>(event) == Event::HeaterReady)
+            {
+                REQUIRE(actions == 0);
+                REQUIRE((next == state || (IsBrewState(state) && next == State::IdleBrew) ||
+                         (IsSteamState(state) && next == State::IdleSteam)));
+            }
+
+            // Only an idle machine goes to sleep, only a sleeping one is woken up by any input
+            if (static_cast<Event>(event) == Event::Inactive)
+                REQUIRE((next == (state == State::IdleBrew ? State::Sleep : state)));
+            if (static_cast<Event>(event) == Event::Activity)
+                REQUIRE((next == (state == State::Sleep ? State::HeatingUpBrew : state)));
+            if (next == State::Sleep && state != State::Sleep)
+                REQUIRE((actions & StateMachine::HeatEco));
+        }
+    }
+}
+
+TEST_CASE("StateMachine::Dispatch logs transitions", "[benchmark][statemachine]")
+{
+    StateMachine machine;
+    REQUIRE(machine.State() == State::Off);
+
+    machine.Dispatch(Event::Click);
+    REQUIRE(machine.State() == State::HeatingUpBrew);
+    machine.Dispatch(Event::HeaterReady);
+    REQUIRE(machine.State() == State::IdleBrew);
+    // Repeated readiness without change is not logged
+    machine.Dispatch(Event::HeaterReady);
+    REQUIRE(machine.LogCount() == 2);
+    REQUIRE(machine.Log(0).from == State::Off);
+    REQUIRE(machine.Log(1).to == State::IdleBrew);
+
+    // The log keeps the newest STATE_LOG_SIZE transitions
+    for (int i = 0; i < STATE_LOG_SIZE; ++i)
+        machine.Dispatch(Event::Click);
+    machine.Dispatch(Event::LongPress);
+    REQUIRE(machine.LogCount() == STATE_LOG_SIZE);
+    REQUIRE(machine.Log(STATE_LOG_SIZE - 1).to == State::Off);
+    REQUIRE(machine.Log(0).event == Event::Click);
+
+    // Sleeps when idle and wakes up on the next input without losing the heat-up
+    machine.Dispatch(Event::Click);
+    machine.Dispatch(Event::HeaterReady);
+    REQUIRE(machine.Dispatch(Event::Inactive).actions == StateMachine::HeatEco);
+    REQUIRE(machine.State() == State::Sleep);
+    machine.Dispatch(Event::HeaterReady);
+    REQUIRE(machine.State() == State::Sleep);
+    REQUIRE((machine.Dispatch(Event::Activity).actions & StateMachine::HeatBrew));
+    REQUIRE(machine.State() == State::HeatingUpBrew);
+    machine.Dispatch(Event::LongPress);
+
+    const auto shortPress = [&] { return machine.Dispatch(Event::ShortPress).actions; };
+    AllocationCounter::Report("StateMachine::Dispatch", shortPress);
+    BENCHMARK("StateMachine::Dispatch") { return shortPress(); };
+}
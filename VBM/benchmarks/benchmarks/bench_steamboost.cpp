@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "steamBoost.hpp"
+
+namespace
+{
+constexpr const double SETPOINT = 125.0;
+constexpr const unsigned long SAMPLE_INTERVAL = 100;
+}  // namespace
+
+TEST_CASE("SteamBoost detects a draw only once settled", "[benchmark][steamboost]")
+{
+    SteamBoost boost;
+    unsigned long now = 0;
+    const auto feed = [&](double Slope, double Temperature, bool Steaming, bool Settled, unsigned long Duration) {
+        for (const unsigned long end = now + Duration; now < end; now += SAMPLE_INTERVAL)
+            boost.Update(Slope, Temperature, SETPOINT, Steaming, Settled, now);
+    };
+
+    SECTION("Not during the heat-up")
+    {
+        // A sag before the boiler settled at steam temperature is not a draw
+        feed(-0.5, SETPOINT - 10, true, false, 30000);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Idle);
+    }
+
+    SECTION("Not for a short dip")
+    {
+        feed(-0.5, SETPOINT - 1, true, true, STEAM_DRAW_DETECT_TIME - 1000);
+        feed(0.0, SETPOINT - 1, true, true, 1000);
+        feed(-0.5, SETPOINT - 1, true, true, STEAM_DRAW_DETECT_TIME - 1000);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Idle);
+    }
+
+    SECTION("Not while brewing")
+    {
+        feed(-0.5, SETPOINT - 1, false, true, 30000);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Idle);
+    }
+
+    SECTION("Boosts, recovers and reports")
+    {
+        feed(-0.5, SETPOINT - 2, true, true, STEAM_DRAW_DETECT_TIME + SAMPLE_INTERVAL);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Boosting);
+        REQUIRE_FALSE(boost.HasNewReport());
+
+        // The draw goes on, the boost follows it
+        feed(-0.3, SETPOINT - 8, true, true, 20000);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Boosting);
+
+        // Wand closed, the temperature turns
+        feed(0.5, SETPOINT - 6, true, true, 10000);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Recovering);
+        REQUIRE(boost.LastBoost() == 20000 + SAMPLE_INTERVAL);
+
+        feed(0.5, SETPOINT - 1, true, true, SAMPLE_INTERVAL);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Idle);
+        REQUIRE(boost.HasNewReport());
+        REQUIRE_FALSE(boost.HasNewReport());
+        REQUIRE(boost.LastRecovery() == 10000);
+    }
+
+    SECTION("Ends after the maximum time")
+    {
+        feed(-0.5, SETPOINT - 2, true, true, STEAM_DRAW_DETECT_TIME + SAMPLE_INTERVAL);
+        feed(-0.5, SETPOINT - 20, true, true, STEAM_BOOST_MAX_TIME);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Recovering);
+        REQUIRE(boost.LastBoost() == STEAM_BOOST_MAX_TIME);
+    }
+
+    SECTION("Leaving steam ends it")
+    {
+        feed(-0.5, SETPOINT - 2, true, true, STEAM_DRAW_DETECT_TIME + SAMPLE_INTERVAL);
+        feed(-0.5, SETPOINT - 2, false, true, SAMPLE_INTERVAL);
+        REQUIRE(boost.Phase() == SteamBoost::Phase::Idle);
+        REQUIRE(boost.HasNewReport());
+        REQUIRE(boost.LastRecovery() == 0);
+    }
+
+    REQUIRE(SteamBoost::BoostSetpoint(SETPOINT) == SETPOINT + STEAM_BOOST_OFFSET);
+    // Up to the margin of the supervisor, but never below the setpoint
+    REQUIRE(SteamBoost::BoostSetpoint(SETPOINT_STEAM_TEMP) == SETPOINT_STEAM_TEMP + STEAM_BOOST_OFFSET);
+    REQUIRE(SteamBoost::BoostSetpoint(MAX_SETPOINT - 1) == MAX_SETPOINT);
+    REQUIRE(SteamBoost::BoostSetpoint(MAX_SETPOINT) == MAX_SETPOINT);
+    REQUIRE(SteamBoost::BoostSetpoint(MAX_SETPOINT + 1) == MAX_SETPOINT + 1);
+
+    const auto update = [&] {
+        now += SAMPLE_INTERVAL;
+        boost.Update(-0.05, SETPOINT, SETPOINT, true, true, now);
+        return boost.Phase();
+    };
+    AllocationCounter::Report("SteamBoost::Update", update);
+    BENCHMARK("SteamBoost::Update") { return update(); };
+}
@@ -0,0 +1,124 @@
+#include <Adafruit_MAX31865.h>
+#include <catch2/catch.hpp>
+
+#include "allocationCounter.hpp"
+#include "supervisor.hpp"
+
+namespace
+{
+typedef Supervisor::Fault Fault;
+
+// One sample every 100 ms like the heater loop, with the SSR on as the PID left it
+void SampleAfter(unsigned long Milliseconds, double Temperature, uint8_t SensorFault = 0)
+{
+    for (unsigned long i = 0; i < Milliseconds; ++i)
+    {
+        Host::AdvanceMillis(1);
+        Supervisor::Tick();
+    }
+    BoilerSsrPin::High();
+    Supervisor::Sample(Temperature, SensorFault);
+}
+
+// The trip must pull the SSR low within one tick
+void RequireSsrLowAfterOneTick()
+{
+    REQUIRE(Host::pinLevel[BOILER_SSR_PIN] == HIGH);
+    Host::AdvanceMicros(1000000UL / TICK_FREQUENCY);
+    Supervisor::Tick();
+    REQUIRE(Host::pinLevel[BOILER_SSR_PIN] == LOW);
+}
+}  // namespace
+
+TEST_CASE("Supervisor passes a normal heat up", "[benchmark][supervisor]")
+{
+    Supervisor::Begin();
+    for (double temperature = 20; temperature < 120; temperature += 0.3)
+        SampleAfter(100, temperature);
+    REQUIRE(Supervisor::Tripped() == Fault::None);
+    REQUIRE(Host::pinLevel[BOILER_SSR_PIN] == HIGH);
+
+    double temperature = 95;
+    const auto sample = [&] {
+        temperature = temperature > 95 ? 94.9 : 95.1;
+        Supervisor::Sample(temperature, 0);
+    };
+    AllocationCounter::Report("Supervisor::Sample", sample);
+    BENCHMARK("Supervisor::Sample") { return sample(); };
+    AllocationCounter::Report("Supervisor::Tick", Supervisor::Tick);
+    BENCHMARK("Supervisor::Tick") { return Supervisor::Tick(); };
+}
+
+TEST_CASE("Supervisor holds the default steam setpoint", "[supervisor]")
+{
+    Supervisor::Begin();
+    double temperature = 20;
+    for (; temperature < SETPOINT_STEAM_TEMP; temperature += 0.3)
+        SampleAfter(100, temperature);
+    // Overshoot and then the PID's ripple around the setpoint for ten minutes
+    for (; temperature < SETPOINT_STEAM_TEMP + 5; temperature += 0.1)
+        SampleAfter(100, temperature);
+    for (; temperature > SETPOINT_STEAM_TEMP; temperature -= 0.1)
+        SampleAfter(100, temperature);
+    for (int i = 0; i < 6000; ++i)
+        SampleAfter(100, SETPOINT_STEAM_TEMP + 0.5 - fabs((i + 5) % 20 - 10) * 0.1);
+    REQUIRE(Supervisor::Tripped() == Fault::None);
+    REQUIRE(SETPOINT_STEAM_TEMP <= MAX_SETPOINT);
+}
+
+TEST_CASE("Supervisor trips and latches", "[benchmark][supervisor]")
+{
+    SECTION("over temperature")
+    {
+        Supervisor::Begin();
+        SampleAfter(100, SUPERVISOR_MAX_TEMP - 0.2);
+        SampleAfter(100, SUPERVISOR_MAX_TEMP + 0.2);
+        REQUIRE(Supervisor::Tripped() == Fault::OverTemperature);
+        RequireSsrLowAfterOneTick();
+        // Samples 100 ms apart and the tick that reacted
+        REQUIRE(Supervisor::WorstReactionLatency() == 100000UL + 1000000UL / TICK_FREQUENCY);
+    }
+    SECTION("implausible slope, like a loose RTD wire")
+    {
+        Supervisor::Begin();
+        SampleAfter(100, 93);
+        SampleAfter(100, 93 + SUPERVISOR_MAX_SLOPE / 10 * 0.9);
+        REQUIRE(Supervisor::Tripped() == Fault::None);
+        SampleAfter(100, 110);
+        REQUIRE(Supervisor::Tripped() == Fault::Slope);
+        RequireSsrLowAfterOneTick();
+    }
+    SECTION("sensor fault")
+    {
+        Supervisor::Begin();
+        SampleAfter(100, 93);
+        SampleAfter(100, 93, MAX31865_FAULT_RTDINLOW);
+        REQUIRE(Supervisor::Tripped() == Fault::Sensor);
+        RequireSsrLowAfterOneTick();
+    }
+    SECTION("missing sensor reads far below zero")
+    {
+        Supervisor::Begin();
+        SampleAfter(100, -242);
+        REQUIRE(Supervisor::Tripped() == Fault::Sensor);
+        RequireSsrLowAfterOneTick();
+    }
+    SECTION("stale sample")
+    {
+        Supervisor::Begin();
+        SampleAfter(100, 93);
+        for (unsigned int i = 0; i < SUPERVISOR_SAMPLE_TIMEOUT; ++i)
+            Supervisor::Tick();
+        REQUIRE(Supervisor::Tripped() == Fault::None);
+        BoilerSsrPin::High();
+        Supervisor::Tick();
+        REQUIRE(Supervisor::Tripped() == Fault::Stale);
+        REQUIRE(Host::pinLevel[BOILER_SSR_PIN] == LOW);
+    }
+
+    // Good samples do not clear a trip, the SSR stays low whatever the heater writes
+    SampleAfter(100, 93);
+    SampleAfter(100, 93);
+    REQUIRE(Supervisor::Tripped() != Fault::None);
+    RequireSsrLowAfterOneTick();
+}
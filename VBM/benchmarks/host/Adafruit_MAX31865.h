@@ -0,0 +1,54 @@
+#ifndef __HOST_ADAFRUIT_MAX31865_H
+#define __HOST_ADAFRUIT_MAX31865_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+typedef enum max31865_numwires
+{
+    MAX31865_2WIRE = 0,
+    MAX31865_3WIRE = 1,
+    MAX31865_4WIRE = 0
+} max31865_numwires_t;
+
+#define MAX31865_FAULT_HIGHTHRESH 0x80
+#define MAX31865_FAULT_LOWTHRESH 0x40
+#define MAX31865_FAULT_REFINLOW 0x20
+#define MAX31865_FAULT_REFINHIGH 0x10
+#define MAX31865_FAULT_RTDINLOW 0x08
+#define MAX31865_FAULT_OVUV 0x04
+
+namespace Host
+{
+// Temperature and fault register every simulated MAX31865 reports, indexed by chip select pin
+extern float rtdTemperature[NUMBER_OF_PINS];
+extern uint8_t rtdFault[NUMBER_OF_PINS];
+extern bool rtdPresent[NUMBER_OF_PINS];
+}  // namespace Host
+
+class Adafruit_MAX31865
+{
+  public:
+    explicit Adafruit_MAX31865(int8_t ChipSelect) : chipSelect_(ChipSelect) {}
+
+    bool begin(max31865_numwires_t Wires = MAX31865_2WIRE)
+    {
+        (void)Wires;
+        Host::spiChipSelect[chipSelect_] = true;
+        pinMode(chipSelect_, OUTPUT);
+        digitalWrite(chipSelect_, HIGH);
+        return Host::rtdPresent[chipSelect_];
+    }
+
+    uint8_t readFault() { return Host::rtdFault[chipSelect_]; }
+    void clearFault() { Host::rtdFault[chipSelect_] = 0; }
+    void enableBias(bool) {}
+    void autoConvert(bool) {}
+
+    float calculateTemperature(uint16_t Rtd, float RtdNominal, float ReferenceResistor);
+
+  private:
+    int8_t chipSelect_;
+};
+
+#endif
@@ -0,0 +1,555 @@
+#include <Arduino.h>
+
+#include <Adafruit_MAX31865.h>
+#include <EEPROM.h>
+#include <RTClib.h>
+#include <SPI.h>
+#include <StuPID.hpp>
+
+#include <cctype>
+#include <cstdio>
+
+#pragma region time and pins
+
+namespace
+{
+unsigned long hostMicros = 0;
+}  // namespace
+
+namespace Host
+{
+unsigned long stringAllocations = 0;
+uint8_t pinLevel[NUMBER_OF_PINS] = {};
+uint8_t pinMode[NUMBER_OF_PINS] = {};
+
+void SetMicros(unsigned long Micros) noexcept { hostMicros = Micros; }
+void AdvanceMillis(unsigned long Milliseconds) noexcept { hostMicros += Milliseconds * 1000UL; }
+void AdvanceMicros(unsigned long Microseconds) noexcept { hostMicros += Microseconds; }
+}  // namespace Host
+
+unsigned long millis() { return hostMicros / 1000UL; }
+unsigned long micros() { return hostMicros; }
+void delay(unsigned long Milliseconds) { Host::AdvanceMillis(Milliseconds); }
+void delayMicroseconds(unsigned int Microseconds) { Host::AdvanceMicros(Microseconds); }
+
+void pinMode(uint8_t Pin, uint8_t Mode)
+{
+    Host::pinMode[Pin] = Mode;
+    if (Mode == INPUT_PULLUP)
+        Host::pinLevel[Pin] = HIGH;
+}
+
+void digitalWrite(uint8_t Pin, uint8_t Value) { Host::pinLevel[Pin] = Value ? HIGH : LOW; }
+
+int digitalRead(uint8_t Pin) { return Host::pinLevel[Pin]; }
+
+int analogRead(uint8_t Pin) { return Host::pinLevel[Pin] ? 1023 : 0; }
+
+char* dtostrf(double Value, signed char Width, unsigned char Precision, char* Buffer)
+{
+    sprintf(Buffer, "%*.*f", Width, Precision, Value);
+    return Buffer;
+}
+
+char* ltoa(long Value, char* Buffer, int Base)
+{
+    // The firmware only formats decimal numbers
+    (void)Base;
+    sprintf(Buffer, "%ld", Value);
+    return Buffer;
+}
+
+#pragma endregion time and pins
+
+#pragma region String
+
+String::String(const char* Text) : buffer_(nullptr), length_(0) { Assign(Text, strlen(Text)); }
+
+String::String(const String& Other) : buffer_(nullptr), length_(0) { Assign(Other.c_str(), Other.length_); }
+
+String::String(char Character) : buffer_(nullptr), length_(0) { Assign(&Character, 1); }
+
+String::String(unsigned char Value, unsigned char Base) : String(static_cast<unsigned long>(Value), Base) {}
+
+String::String(int Value, unsigned char Base) : String(static_cast<long>(Value), Base) {}
+
+String::String(unsigned int Value, unsigned char Base) : String(static_cast<unsigned long>(Value), Base) {}
+
+String::String(long Value, unsigned char Base) : buffer_(nullptr), length_(0)
+{
+    char text[34];
+    if (Base == 10)
+        snprintf(text, sizeof(text), "%ld", Value);
+    else
+        snprintf(text, sizeof(text), Base == 16 ? "%lx" : "%lo", static_cast<unsigned long>(Value));
+    Assign(text, strlen(text));
+}
+
+String::String(unsigned long Value, unsigned char Base) : buffer_(nullptr), length_(0)
+{
+    char text[34];
+    snprintf(text, sizeof(text), Base == 16 ? "%lx" : (Base == 8 ? "%lo" : "%lu"), Value);
+    Assign(text, strlen(text));
+}
+
+String::String(float Value, unsigned char Decimals) : String(static_cast<double>(Value), Decimals) {}
+
+String::String(double Value, unsigned char Decimals) : buffer_(nullptr), length_(0)
+{
+    char text[40];
+    snprintf(text, sizeof(text), "%.*f", Decimals, Value);
+    Assign(text, strlen(text));
+}
+
+String::~String() { delete[] buffer_; }
+
+String& String::operator=(const String& Other)
+{
+    if (this != &Other)
+        Assign(Other.c_str(), Other.length_);
+    return *this;
+}
+
+String& String::operator=(const char* Text)
+{
+    Assign(Text, strlen(Text));
+    return *this;
+}
+
+void String::Assign(const char* Text, unsigned int Length)
+{
+    if (!Length)
+    {
+        // WString keeps its buffer on assignment of an empty string
+        length_ = 0;
+        if (buffer_)
+            buffer_[0] = '\0';
+        return;
+    }
+    if (!buffer_ || Length > length_)
+    {
+        delete[] buffer_;
+        buffer_ = new char[Length + 1];
+        ++Host::stringAllocations;
+    }
+    memcpy(buffer_, Text, Length);
+    buffer_[Length] = '\0';
+    length_ = Length;
+}
+
+String& String::Concat(const char* Text, unsigned int Length)
+{
+    if (!Length)
+        return *this;
+    char* grown = new char[length_ + Length + 1];
+    ++Host::stringAllocations;
+    if (length_)
+        memcpy(grown, buffer_, length_);
+    memcpy(grown + length_, Text, Length);
+    grown[length_ + Length] = '\0';
+    delete[] buffer_;
+    buffer_ = grown;
+    length_ += Length;
+    return *this;
+}
+
+int String::indexOf(char Character) const
+{
+    const char* found = strchr(c_str(), Character);
+    return found ? static_cast<int>(found - c_str()) : -1;
+}
+
+int String::indexOf(const String& Text) const
+{
+    const char* found = strstr(c_str(), Text.c_str());
+    return found ? static_cast<int>(found - c_str()) : -1;
+}
+
+int String::lastIndexOf(char Character) const
+{
+    const char* found = strrchr(c_str(), Character);
+    return found ? static_cast<int>(found - c_str()) : -1;
+}
+
+bool String::startsWith(const String& Prefix) const
+{
+    return length_ >= Prefix.length_ && strncmp(c_str(), Prefix.c_str(), Prefix.length_) == 0;
+}
+
+String String::substring(unsigned int From, unsigned int To) const
+{
+    if (From > To)
+    {
+        const auto tmp = From;
+        From = To;
+        To = tmp;
+    }
+    if (From >= length_)
+        return String();
+    if (To > length_)
+        To = length_;
+    String result;
+    result.Assign(buffer_ + From, To - From);
+    return result;
+}
+
+void String::toLowerCase()
+{
+    for (unsigned int i = 0; i < length_; ++i)
+        buffer_[i] = static_cast<char>(tolower(buffer_[i]));
+}
+
+void String::trim()
+{
+    if (!length_)
+        return;
+    unsigned int begin = 0;
+    while (begin < length_ && isspace(static_cast<unsigned char>(buffer_[begin])))
+        ++begin;
+    unsigned int end = length_;
+    while (end > begin && isspace(static_cast<unsigned char>(buffer_[end - 1])))
+        --end;
+    length_ = end - begin;
+    if (begin)
+        memmove(buffer_, buffer_ + begin, length_);
+    buffer_[length_] = '\0';
+}
+
+String operator+(const String& Lhs, const String& Rhs)
+{
+    String result(Lhs);
+    result += Rhs;
+    return result;
+}
+
+String operator+(const String& Lhs, const char* Rhs)
+{
+    String result(Lhs);
+    result += Rhs;
+    return result;
+}
+
+String operator+(const String& Lhs, char Rhs)
+{
+    String result(Lhs);
+    result += Rhs;
+    return result;
+}
+
+String operator+(const String& Lhs, unsigned char Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, int Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, unsigned int Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, long Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, unsigned long Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, float Rhs) { return Lhs + String(Rhs); }
+String operator+(const String& Lhs, double Rhs) { return Lhs + String(Rhs); }
+
+#pragma endregion String
+
+#pragma region Serial
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long Baud) { baud_ = Baud; }
+
+int HardwareSerial::read()
+{
+    if (!available())
+        return -1;
+    return static_cast<unsigned char>(rx_[rxPosition_++]);
+}
+
+int HardwareSerial::availableForWrite() const
+{
+    if (txCapacity_ < 0)
+        return 63;
+    return txCapacity_ > txPending_ ? txCapacity_ - txPending_ : 0;
+}
+
+size_t HardwareSerial::write(uint8_t Byte) { return write(&Byte, 1); }
+
+size_t HardwareSerial::write(const uint8_t* Buffer, size_t Size)
+{
+    if (captureTx_)
+        tx_.append(reinterpret_cast<const char*>(Buffer), Size);
+    bytesTransmitted_ += Size;
+    if (txCapacity_ >= 0)
+        txPending_ += static_cast<int>(Size);
+    return Size;
+}
+
+void HardwareSerial::HostReceive(const char* Text)
+{
+    if (rxPosition_ == rx_.size())
+    {
+        rx_.clear();
+        rxPosition_ = 0;
+    }
+    rx_ += Text;
+}
+
+void HardwareSerial::HostDrainTx(unsigned long Microseconds)
+{
+    // 10 bits per byte on the wire
+    const auto drained = static_cast<int>(static_cast<unsigned long long>(baud_) * Microseconds / 10000000ULL);
+    txPending_ = txPending_ > drained ? txPending_ - drained : 0;
+}
+
+#pragma endregion Serial
+
+#pragma region EEPROM
+
+EEPROMClass EEPROM;
+
+#pragma endregion EEPROM
+
+#pragma region RTClib
+
+namespace
+{
+const uint8_t DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+// RTC time as offset to the simulated millis() time
+uint32_t rtcUnixAtSet = SECONDS_FROM_1970_TO_2000;
+unsigned long rtcMillisAtSet = 0;
+
+uint16_t DaysSince2000(uint16_t Year, uint8_t Month, uint8_t Day)
+{
+    if (Year >= 2000U)
+        Year -= 2000U;
+    uint16_t days = Day;
+    for (uint8_t i = 1; i < Month; ++i)
+        days += DAYS_IN_MONTH[i - 1];
+    if (Month > 2 && Year % 4 == 0)
+        ++days;
+    return days + 365 * Year + (Year + 3) / 4 - 1;
+}
+}  // namespace
+
+namespace Host
+{
+bool rtcPresent = true;
+}  // namespace Host
+
+DateTime::DateTime(uint32_t UnixTime)
+{
+    UnixTime -= SECONDS_FROM_1970_TO_2000;
+    ss_ = UnixTime % 60;
+    UnixTime /= 60;
+    mm_ = UnixTime % 60;
+    UnixTime /= 60;
+    hh_ = UnixTime % 24;
+    uint16_t days = UnixTime / 24;
+    uint8_t leap;
+    for (yOff_ = 0;; ++yOff_)
+    {
+        leap = yOff_ % 4 == 0;
+        if (days < 365U + leap)
+            break;
+        days -= 365 + leap;
+    }
+    for (m_ = 1; m_ < 12; ++m_)
+    {
+        uint8_t daysPerMonth = DAYS_IN_MONTH[m_ - 1];
+        if (leap && m_ == 2)
+            ++daysPerMonth;
+        if (days < daysPerMonth)
+            break;
+        days -= daysPerMonth;
+    }
+    d_ = days + 1;
+}
+
+DateTime::DateTime(uint16_t Year, uint8_t Month, uint8_t Day, uint8_t Hour, uint8_t Minute, uint8_t Second)
+    : yOff_(Year >= 2000U ? Year - 2000U : Year), m_(Month), d_(Day), hh_(Hour), mm_(Minute), ss_(Second)
+{
+}
+
+uint8_t DateTime::dayOfTheWeek() const
+{
+    // 2000-01-01 was a Saturday
+    return (DaysSince2000(yOff_, m_, d_) + 6) % 7;
+}
+
+uint32_t DateTime::unixtime() const
+{
+    const uint32_t days = DaysSince2000(yOff_, m_, d_);
+    return SECONDS_FROM_1970_TO_2000 + ((days * 24UL + hh_) * 60 + mm_) * 60 + ss_;
+}
+
+void RTC_DS3231::adjust(const DateTime& Time)
+{
+    rtcUnixAtSet = Time.unixtime();
+    rtcMillisAtSet = millis();
+}
+
+DateTime RTC_DS3231::now() { return DateTime(rtcUnixAtSet + (millis() - rtcMillisAtSet) / 1000UL); }
+
+#pragma endregion RTClib
+
+#pragma region MAX31865
+
+namespace
+{
+constexpr const float RTD_A = 3.9083e-3f;
+constexpr const float RTD_B = -5.775e-7f;
+
+struct RtdDefaults
+{
+    RtdDefaults()
+    {
+        for (int i = 0; i < Host::NUMBER_OF_PINS; ++i)
+        {
+            Host::rtdTemperature[i] = 20.0f;
+            Host::rtdPresent[i] = true;
+        }
+    }
+};
+}  // namespace
+
+namespace Host
+{
+float rtdTemperature[NUMBER_OF_PINS];
+uint8_t rtdFault[NUMBER_OF_PINS] = {};
+bool rtdPresent[NUMBER_OF_PINS];
+}  // namespace Host
+
+namespace
+{
+const RtdDefaults rtdDefaults;
+}  // namespace
+
+namespace
+{
+// Registers of the simulated chips, indexed by chip select pin
+uint8_t rtdConfig[Host::NUMBER_OF_PINS] = {};
+uint16_t rtdConverted[Host::NUMBER_OF_PINS] = {};
+
+uint16_t RtdRaw(float Temperature)
+{
+    // Assume the PT1000 / 4300 Ohm combination of settings.hpp
+    const float resistance = 1000.0f * (1.0f + RTD_A * Temperature + RTD_B * Temperature * Temperature);
+    return static_cast<uint16_t>(resistance / 4300.0f * 32768.0f);
+}
+
+int SelectedChip()
+{
+    for (int pin = 0; pin < Host::NUMBER_OF_PINS; ++pin)
+        if (Host::spiChipSelect[pin] && Host::pinMode[pin] == OUTPUT && Host::pinLevel[pin] == LOW)
+            return pin;
+    return -1;
+}
+
+uint8_t ReadRegister(int Chip, uint8_t Address)
+{
+    switch (Address)
+    {
+        case 0x00:
+            return rtdConfig[Chip];
+        // The lowest bit of the RTD register flags a fault
+        case 0x01:
+            return rtdConverted[Chip] >> 7;
+        case 0x02:
+            return (rtdConverted[Chip] << 1 | (Host::rtdFault[Chip] ? 1 : 0)) & 0xFF;
+        case 0x03:
+        case 0x04:
+            return 0xFF;
+        case 0x07:
+            return Host::rtdFault[Chip];
+        default:
+            return 0;
+    }
+}
+
+void WriteRegister(int Chip, uint8_t Address, uint8_t Value)
+{
+    if (Address != 0x00)
+        return;
+    // Fault clear and one-shot clear themselves
+    if (Value & 0x02)
+        Host::rtdFault[Chip] = 0;
+    if ((Value & 0x20) && (Value & 0x80))
+        rtdConverted[Chip] = RtdRaw(Host::rtdTemperature[Chip]);
+    rtdConfig[Chip] = Value & ~0x22;
+}
+}  // namespace
+
+namespace Host
+{
+bool spiChipSelect[NUMBER_OF_PINS] = {};
+unsigned long spiTransactions = 0;
+}  // namespace Host
+
+SPIClass SPI;
+
+uint8_t SPIClass::transfer(uint8_t Data)
+{
+    const int chip = SelectedChip();
+    if (chip < 0 || !Host::rtdPresent[chip])
+        return 0;
+    if (first_)
+    {
+        first_ = false;
+        write_ = Data & 0x80;
+        address_ = Data & 0x7F;
+        return 0;
+    }
+    // Multi-byte transfers move on to the next register
+    const uint8_t address = address_++;
+    if (write_)
+    {
+        WriteRegister(chip, address, Data);
+        return 0;
+    }
+    return ReadRegister(chip, address);
+}
+
+float Adafruit_MAX31865::calculateTemperature(uint16_t Rtd, float RtdNominal, float ReferenceResistor)
+{
+    const float resistance = Rtd / 32768.0f * ReferenceResistor;
+    const float z1 = -RTD_A;
+    const float z2 = RTD_A * RTD_A - (4 * RTD_B);
+    const float z3 = (4 * RTD_B) / RtdNominal;
+    const float z4 = 2 * RTD_B;
+    return (z1 + sqrtf(z2 + (z3 * resistance))) / z4;
+}
+
+#pragma endregion MAX31865
+
+#pragma region StuPID
+
+void StuPIDRelay::run()
+{
+    const auto now = millis();
+    if (stopped_)
+    {
+        stopped_ = false;
+        lastStep_ = now;
+        lastPulseTime_ = now;
+        integral_ = 0;
+        previousError_ = *setpoint_ - *input_;
+    }
+
+    const auto elapsed = now - lastStep_;
+    if (elapsed >= 100)
+    {
+        const double error = *setpoint_ - *input_;
+        integral_ = constrain(integral_ + error * elapsed, -1.0 / (*ki_ ? *ki_ : 1.0), 1.0 / (*ki_ ? *ki_ : 1.0));
+        const double derivative = (error - previousError_) / elapsed;
+        pulseValue_ = constrain(*kp_ * error + *ki_ * integral_ + *kd_ * derivative, 0.0, 1.0);
+        previousError_ = error;
+        lastStep_ = now;
+    }
+
+    while (now - lastPulseTime_ > pulseWidth_)
+        lastPulseTime_ += static_cast<unsigned long>(pulseWidth_);
+    *relayState_ = (now - lastPulseTime_) < pulseValue_ * pulseWidth_;
+}
+
+void StuPIDRelay::stop()
+{
+    stopped_ = true;
+    integral_ = 0;
+}
+
+#pragma endregion StuPID
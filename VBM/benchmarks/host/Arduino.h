@@ -0,0 +1,199 @@
+#ifndef __HOST_ARDUINO_H
+#define __HOST_ARDUINO_H
+
+// Minimal host stand-in for the Arduino core so the firmware sources in ../VBM compile and run on a PC.
+// Only what the firmware uses is provided. Time, pins and the serial port are driven by the Host namespace.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define F(string_literal) (string_literal)
+
+#define interrupts()
+#define noInterrupts()
+
+namespace Host
+{
+constexpr const int NUMBER_OF_PINS = 22;
+
+// Simulated time, advanced explicitly by the benchmark or simulation
+void SetMicros(unsigned long Micros) noexcept;
+void AdvanceMillis(unsigned long Milliseconds) noexcept;
+void AdvanceMicros(unsigned long Microseconds) noexcept;
+
+// Simulated pin levels, inputs can be set from outside, outputs are written by the firmware
+extern uint8_t pinLevel[NUMBER_OF_PINS];
+extern uint8_t pinMode[NUMBER_OF_PINS];
+}  // namespace Host
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long Milliseconds);
+void delayMicroseconds(unsigned int Microseconds);
+
+void pinMode(uint8_t Pin, uint8_t Mode);
+void digitalWrite(uint8_t Pin, uint8_t Value);
+int digitalRead(uint8_t Pin);
+int analogRead(uint8_t Pin);
+
+char* dtostrf(double Value, signed char Width, unsigned char Precision, char* Buffer);
+char* ltoa(long Value, char* Buffer, int Base);
+
+// Functions instead of the core's macros so std headers included after this one stay intact
+template <class T, class U>
+inline T constrain(T Value, U Low, U High)
+{
+    return Value < Low ? static_cast<T>(Low) : (Value > High ? static_cast<T>(High) : Value);
+}
+
+// Heap backed string with the same growth behaviour as the Arduino WString: every non-empty string owns
+// exactly one allocation, sized to fit, so allocation counts on host match the target.
+class String
+{
+  public:
+    String(const char* Text = "");
+    String(const String& Other);
+    explicit String(char Character);
+    explicit String(unsigned char Value, unsigned char Base = 10);
+    explicit String(int Value, unsigned char Base = 10);
+    explicit String(unsigned int Value, unsigned char Base = 10);
+    explicit String(long Value, unsigned char Base = 10);
+    explicit String(unsigned long Value, unsigned char Base = 10);
+    explicit String(float Value, unsigned char Decimals = 2);
+    explicit String(double Value, unsigned char Decimals = 2);
+    ~String();
+
+    String& operator=(const String& Other);
+    String& operator=(const char* Text);
+
+    String& operator+=(const String& Other) { return Concat(Other.buffer_ ? Other.buffer_ : "", Other.length_); }
+    String& operator+=(const char* Text) { return Concat(Text, strlen(Text)); }
+    String& operator+=(char Character) { return Concat(&Character, 1); }
+
+    bool operator==(const String& Other) const { return strcmp(c_str(), Other.c_str()) == 0; }
+    bool operator==(const char* Text) const { return strcmp(c_str(), Text) == 0; }
+    bool operator!=(const char* Text) const { return !(*this == Text); }
+
+    unsigned int length() const { return length_; }
+    const char* c_str() const { return buffer_ ? buffer_ : ""; }
+    char operator[](unsigned int Index) const { return Index < length_ ? buffer_[Index] : 0; }
+
+    int indexOf(char Character) const;
+    int indexOf(const String& Text) const;
+    int lastIndexOf(char Character) const;
+    bool startsWith(const String& Prefix) const;
+    String substring(unsigned int From) const { return substring(From, length_); }
+    String substring(unsigned int From, unsigned int To) const;
+    void toLowerCase();
+    void trim();
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return static_cast<float>(atof(c_str())); }
+
+  private:
+    String& Concat(const char* Text, unsigned int Length);
+    void Assign(const char* Text, unsigned int Length);
+
+    char* buffer_;
+    unsigned int length_;
+};
+
+String operator+(const String& Lhs, const String& Rhs);
+String operator+(const String& Lhs, const char* Rhs);
+String operator+(const String& Lhs, char Rhs);
+String operator+(const String& Lhs, unsigned char Rhs);
+String operator+(const String& Lhs, int Rhs);
+String operator+(const String& Lhs, unsigned int Rhs);
+String operator+(const String& Lhs, long Rhs);
+String operator+(const String& Lhs, unsigned long Rhs);
+String operator+(const String& Lhs, float Rhs);
+String operator+(const String& Lhs, double Rhs);
+
+// Serial port with an injectable receive buffer and a bounded transmit buffer that drains with simulated time
+class HardwareSerial
+{
+  public:
+    void begin(unsigned long Baud);
+    void end() {}
+    explicit operator bool() const { return true; }
+
+    int available() const { return static_cast<int>(rx_.size() - rxPosition_); }
+    int read();
+    int peek() const { return available() ? static_cast<unsigned char>(rx_[rxPosition_]) : -1; }
+    int availableForWrite() const;
+    void flush() {}
+
+    size_t write(uint8_t Byte);
+    size_t write(const uint8_t* Buffer, size_t Size);
+    size_t write(const char* Text) { return write(reinterpret_cast<const uint8_t*>(Text), strlen(Text)); }
+
+    size_t print(const char* Text) { return write(Text); }
+    size_t print(const String& Text) { return write(Text.c_str()); }
+    size_t print(char Character) { return write(static_cast<uint8_t>(Character)); }
+    size_t print(unsigned char Value, int Base = 10) { return print(String(Value, Base)); }
+    size_t print(int Value, int Base = 10) { return print(String(Value, Base)); }
+    size_t print(unsigned int Value, int Base = 10) { return print(String(Value, Base)); }
+    size_t print(long Value, int Base = 10) { return print(String(Value, Base)); }
+    size_t print(unsigned long Value, int Base = 10) { return print(String(Value, Base)); }
+    size_t print(double Value, int Digits = 2) { return print(String(Value, Digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <class T>
+    size_t println(const T& Value)
+    {
+        const auto written = print(Value);
+        return written + println();
+    }
+    template <class T>
+    size_t println(const T& Value, int Format)
+    {
+        const auto written = print(Value, Format);
+        return written + println();
+    }
+
+    // Host side helpers
+    void HostReceive(const char* Text);
+    const std::string& HostTransmitted() const { return tx_; }
+    void HostClearTransmitted() { tx_.clear(); }
+    void HostSetCaptureTransmitted(bool Capture) { captureTx_ = Capture; }
+    void HostSetTxCapacity(int Capacity) { txCapacity_ = Capacity; }
+    void HostDrainTx(unsigned long Microseconds);
+    unsigned long HostBytesTransmitted() const { return bytesTransmitted_; }
+
+  private:
+    std::string rx_;
+    std::size_t rxPosition_ = 0;
+    std::string tx_;
+    bool captureTx_ = false;
+    int txCapacity_ = -1;  // -1: unbounded, the host never blocks
+    int txPending_ = 0;
+    unsigned long baud_ = 57600;
+    unsigned long bytesTransmitted_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef __HOST_EEPROM_H
+#define __HOST_EEPROM_H
+
+#include <cstdint>
+
+// 1 KB EEPROM of the ATmega328P, erased to 0xFF like a fresh part. Counts writes to judge wear policies.
+class EEPROMClass
+{
+  public:
+    static constexpr const int SIZE = 1024;
+
+    uint8_t read(int Address) const { return memory_[Address]; }
+    void write(int Address, uint8_t Value)
+    {
+        memory_[Address] = Value;
+        ++writes_;
+    }
+    void update(int Address, uint8_t Value)
+    {
+        if (memory_[Address] != Value)
+            write(Address, Value);
+    }
+    int length() const { return SIZE; }
+
+    template <class T>
+    T& get(int Address, T& Value) const
+    {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&Value);
+        for (unsigned int i = 0; i < sizeof(T); ++i)
+            bytes[i] = read(Address + i);
+        return Value;
+    }
+
+    template <class T>
+    const T& put(int Address, const T& Value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&Value);
+        for (unsigned int i = 0; i < sizeof(T); ++i)
+            update(Address + i, bytes[i]);
+        return Value;
+    }
+
+    // Host side helpers
+    void HostErase()
+    {
+        for (auto& byte : memory_)
+            byte = 0xFF;
+        writes_ = 0;
+    }
+    unsigned long HostWrites() const { return writes_; }
+
+  private:
+    uint8_t memory_[SIZE] = {};
+    unsigned long writes_ = 0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __HOST_RTCLIB_H
+#define __HOST_RTCLIB_H
+
+#include <Arduino.h>
+
+// Unix time 2000-01-01 00:00:00, the epoch of the DS3231
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+// Broken down time in the same shape as RTClib's DateTime
+class DateTime
+{
+  public:
+    DateTime(uint32_t UnixTime = SECONDS_FROM_1970_TO_2000);
+    DateTime(uint16_t Year, uint8_t Month, uint8_t Day, uint8_t Hour = 0, uint8_t Minute = 0, uint8_t Second = 0);
+
+    uint16_t year() const { return 2000U + yOff_; }
+    uint8_t month() const { return m_; }
+    uint8_t day() const { return d_; }
+    uint8_t hour() const { return hh_; }
+    uint8_t minute() const { return mm_; }
+    uint8_t second() const { return ss_; }
+
+    // Day of the week, 0 = Sunday
+    uint8_t dayOfTheWeek() const;
+
+    uint32_t unixtime() const;
+
+  private:
+    uint8_t yOff_, m_, d_, hh_, mm_, ss_;
+};
+
+namespace Host
+{
+// Whether the simulated DS3231 answers on the bus
+extern bool rtcPresent;
+}  // namespace Host
+
+// DS3231 that keeps running with the simulated millis() time
+class RTC_DS3231
+{
+  public:
+    bool begin() { return Host::rtcPresent; }
+    bool lostPower() { return false; }
+    void adjust(const DateTime& Time);
+    DateTime now();
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef __HOST_SPI_H
+#define __HOST_SPI_H
+
+#include <Arduino.h>
+
+// Hardware SPI with simulated MAX31865 chips behind it, one per chip select pin, see Adafruit_MAX31865.h for their
+// temperature, fault and presence. A transaction goes to the chip whose select pin was set up by its begin() and is
+// driven low. A one-shot conversion latches the temperature of that moment, a missing chip answers 0.
+
+#define MSBFIRST 1
+#define SPI_MODE1 0x04
+
+class SPISettings
+{
+  public:
+    SPISettings() {}
+    SPISettings(uint32_t Clock, uint8_t BitOrder, uint8_t DataMode)
+    {
+        (void)Clock;
+        (void)BitOrder;
+        (void)DataMode;
+    }
+};
+
+namespace Host
+{
+// Pins a MAX31865 is selected with, set by its begin()
+extern bool spiChipSelect[NUMBER_OF_PINS];
+// Number of SPI transactions so far
+extern unsigned long spiTransactions;
+}  // namespace Host
+
+class SPIClass
+{
+  public:
+    void begin() {}
+    void beginTransaction(SPISettings)
+    {
+        ++Host::spiTransactions;
+        first_ = true;
+    }
+    uint8_t transfer(uint8_t Data);
+    void endTransaction() {}
+
+  private:
+    bool first_ = true;
+    bool write_ = false;
+    uint8_t address_ = 0;
+};
+
+extern SPIClass SPI;
+
+#endif
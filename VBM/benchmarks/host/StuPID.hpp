@@ -0,0 +1,38 @@
+#ifndef __HOST_STUPID_HPP
+#define __HOST_STUPID_HPP
+
+#include <Arduino.h>
+
+// Host version of https://github.com/nekowokaburu/StuPID with the same interface: a PID whose [0, 1] output is
+// turned into a relay state within a time proportional window.
+class StuPIDRelay
+{
+  public:
+    StuPIDRelay(double* Input, double* Setpoint, bool* RelayState, double PulseWidth, const double* Kp,
+                const double* Ki, const double* Kd)
+        : input_(Input), setpoint_(Setpoint), relayState_(RelayState), pulseWidth_(PulseWidth), kp_(Kp), ki_(Ki), kd_(Kd)
+    {
+    }
+
+    void run();
+    void stop();
+    double getPulseValue() const { return pulseValue_; }
+
+  private:
+    double* input_;
+    double* setpoint_;
+    bool* relayState_;
+    double pulseWidth_;
+    const double* kp_;
+    const double* ki_;
+    const double* kd_;
+
+    double pulseValue_ = 0;
+    double integral_ = 0;
+    double previousError_ = 0;
+    unsigned long lastStep_ = 0;
+    unsigned long lastPulseTime_ = 0;
+    bool stopped_ = true;
+};
+
+#endif
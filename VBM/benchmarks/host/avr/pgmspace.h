@@ -0,0 +1,23 @@
+#ifndef __HOST_AVR_PGMSPACE_H
+#define __HOST_AVR_PGMSPACE_H
+
+// On host there is a single address space, so flash reads are plain reads.
+
+#include <cstdint>
+#include <cstring>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(string_literal) (string_literal)
+
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t*>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t*>(address))
+#define pgm_read_dword(address) (*reinterpret_cast<const uint32_t*>(address))
+#define pgm_read_float(address) (*reinterpret_cast<const float*>(address))
+
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+
+#endif
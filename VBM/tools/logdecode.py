@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Decodes the tokenized log records of the firmware (see VBM/logger.hpp) back into text.
+
+Records are lines starting with '~' followed by hex bytes: the flash address of the format string (little endian),
+then for each argument a tag and the value bytes. The format strings are read from the flash image the firmware
+was built to, either the .hex of "Sketch > Export compiled binary" or the .elf of the build directory.
+All other lines (app messages like >temp:93.5) are passed through unchanged.
+
+Usage:
+    logdecode.py VBM.ino.hex < captured.log
+    stty -F /dev/ttyUSB0 57600 raw && logdecode.py build/VBM.ino.elf < /dev/ttyUSB0
+"""
+
+import struct
+import sys
+
+
+def read_intel_hex(path):
+    flash = bytearray()
+    base = 0
+    with open(path) as file:
+        for line in file:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            record = bytes.fromhex(line[1:])
+            length, address, kind = record[0], (record[1] << 8) | record[2], record[3]
+            data = record[4:4 + length]
+            if kind == 0:
+                start = base + address
+                if len(flash) < start + length:
+                    flash.extend(b"\xff" * (start + length - len(flash)))
+                flash[start:start + length] = data
+            elif kind == 2:
+                base = ((data[0] << 8) | data[1]) << 4
+            elif kind == 4:
+                base = ((data[0] << 8) | data[1]) << 16
+    return bytes(flash)
+
+
+def read_elf(path):
+    with open(path, "rb") as file:
+        elf = file.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        raise ValueError("not a 32 bit ELF file")
+    program_headers = struct.unpack_from("<I", elf, 28)[0]
+    header_size, header_count = struct.unpack_from("<HH", elf, 42)
+    flash = bytearray()
+    for i in range(header_count):
+        kind, offset, _, physical, size, _, _, _ = struct.unpack_from("<8I", elf, program_headers + i * header_size)
+        # Loadable segments below the AVR data address space (0x800000) are flash
+        if kind != 1 or physical >= 0x800000 or size == 0:
+            continue
+        if len(flash) < physical + size:
+            flash.extend(b"\xff" * (physical + size - len(flash)))
+        flash[physical:physical + size] = elf[offset:offset + size]
+    return bytes(flash)
+
+
+def format_string(flash, address):
+    end = flash.find(b"\0", address)
+    if address >= len(flash) or end < 0:
+        return None
+    return flash[address:end].decode("ascii", "replace")
+
+
+def decode_arguments(data):
+    arguments = []
+    position = 0
+    while position < len(data):
+        tag = data[position]
+        kind, size = tag >> 4, tag & 0x0F
+        position += 1
+        if kind == 3:
+            size = data[position]
+            arguments.append(data[position + 1:position + 1 + size].decode("ascii", "replace"))
+            position += 1 + size
+            continue
+        value = data[position:position + size]
+        position += size
+        if len(value) != size:
+            arguments.append("<cut>")
+        elif kind == 0:
+            arguments.append(int.from_bytes(value, "little", signed=True))
+        elif kind == 1:
+            arguments.append(int.from_bytes(value, "little", signed=False))
+        elif kind == 2:
+            arguments.append(round(struct.unpack("<f", value)[0], 6))
+        else:
+            arguments.append("<tag %02x>" % tag)
+    return arguments
+
+
+def decode(flash, line):
+    try:
+        data = bytes.fromhex(line[1:])
+    except ValueError:
+        return line
+    if len(data) < 2:
+        return line
+    address = data[0] | (data[1] << 8)
+    text = format_string(flash, address)
+    arguments = decode_arguments(data[2:])
+    if text is None:
+        return "<unknown log id 0x%04x> %s" % (address, arguments)
+    for argument in arguments:
+        if "{}" not in text:
+            text += " %s" % (argument,)
+        else:
+            text = text.replace("{}", str(argument), 1)
+    return text
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__, file=sys.stderr)
+        return 1
+    path = sys.argv[1]
+    flash = read_elf(path) if path.endswith(".elf") else read_intel_hex(path)
+    for line in sys.stdin.buffer:
+        line = line.decode("ascii", "replace").rstrip("\r\n")
+        print(decode(flash, line) if line.startswith("~") else line, flush=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())